@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "cache.h"
+
+using namespace llvm;
+
+// naikkan apabila isi entri berubah format
+static const char *kCacheFormat = "bosojowo-cache-1";
+
+// file sementara penulis yang crash dibersihkan setelah ini
+static const time_t kStaleTemporarySeconds = 3600;
+
+std::string defaultCacheDirectory()
+{
+    if (const char *dir = getenv("BOSOJOWO_CACHE")) {
+        return dir;
+    }
+    if (const char *dir = getenv("XDG_CACHE_HOME")) {
+        return std::string(dir) + "/bosojowo";
+    }
+    if (const char *home = getenv("HOME")) {
+        return std::string(home) + "/.cache/bosojowo";
+    }
+    return "";
+}
+
+std::string hashHex(StringRef data)
+{
+    MD5 hash;
+    hash.update(data);
+    MD5::MD5Result result;
+    hash.final(result);
+    SmallString<32> hex;
+    MD5::stringifyResult(result, hex);
+    return hex.str().str();
+}
+
+static bool readFile(const std::string& path, std::string& data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    data = contents.str();
+    return !in.bad();
+}
+
+static bool writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+    return (bool)out;
+}
+
+CompileCache::CompileCache(const std::string& dir, uint64_t maxBytes) :
+    dir(dir.empty() ? defaultCacheDirectory() : dir), maxBytes(maxBytes)
+{
+}
+
+bool CompileCache::load(const std::string& name, std::string& data)
+{
+    if (dir.empty()) {
+        return false;
+    }
+    std::string path = dir + "/" + name;
+    if (!readFile(path, data)) {
+        return false;
+    }
+    // dipakai lagi: paling akhir dievict
+    utime(path.c_str(), nullptr);
+    return true;
+}
+
+bool CompileCache::save(const std::string& name, StringRef data)
+{
+    if (dir.empty() || sys::fs::create_directories(dir)) {
+        return false;
+    }
+    int fd;
+    SmallString<128> tmpPath;
+    if (sys::fs::createUniqueFile(dir + "/" + name + "-%%%%%%.tmp", fd, tmpPath)) {
+        return false;
+    }
+    bool written;
+    {
+        raw_fd_ostream out(fd, true);
+        out << data;
+        out.close();
+        written = !out.has_error();
+        out.clear_error();
+    }
+    if (!written || sys::fs::rename(tmpPath, dir + "/" + name)) {
+        sys::fs::remove(tmpPath);
+        return false;
+    }
+    evict();
+    return true;
+}
+
+bool CompileCache::loadToFile(const std::string& name, const std::string& path)
+{
+    std::string data;
+    return load(name, data) && writeFile(path, data);
+}
+
+bool CompileCache::saveFile(const std::string& name, const std::string& path)
+{
+    std::string data;
+    return readFile(path, data) && save(name, data);
+}
+
+struct CacheEntry {
+    std::string path;
+    uint64_t size;
+    time_t mtime;
+};
+
+void CompileCache::evict()
+{
+    std::string lockPath = dir + "/lock";
+    int lock = open(lockPath.c_str(), O_CREAT | O_RDWR, 0666);
+    if (lock < 0) {
+        return;
+    }
+    // proses lain sedang evict, cukup satu
+    if (flock(lock, LOCK_EX | LOCK_NB) != 0) {
+        close(lock);
+        return;
+    }
+
+    std::vector<CacheEntry> entries;
+    uint64_t total = 0;
+    time_t now = time(nullptr);
+
+    if (DIR *d = opendir(dir.c_str())) {
+        while (struct dirent *ent = readdir(d)) {
+            std::string name = ent->d_name;
+            if (name == "." || name == ".." || name == "lock") {
+                continue;
+            }
+            CacheEntry entry;
+            entry.path = dir + "/" + name;
+            struct stat st;
+            if (stat(entry.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+            // file sementara yang masih ditulis tidak boleh disentuh
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+                if (now - st.st_mtime > kStaleTemporarySeconds) {
+                    unlink(entry.path.c_str());
+                }
+                continue;
+            }
+            entry.size = st.st_size;
+            entry.mtime = st.st_mtime;
+            total += entry.size;
+            entries.push_back(entry);
+        }
+        closedir(d);
+    }
+
+    if (total > maxBytes) {
+        std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) {
+            return a.mtime < b.mtime;
+        });
+        uint64_t target = maxBytes / 10 * 9;
+        for (const CacheEntry& entry : entries) {
+            if (total <= target) {
+                break;
+            }
+            if (unlink(entry.path.c_str()) == 0) {
+                total -= entry.size;
+            }
+        }
+    }
+
+    flock(lock, LOCK_UN);
+    close(lock);
+}
+
+/* Argumen yang tidak mengubah hasil kompilasi, atau yang isinya di-hash terpisah. */
+static bool ignoredCacheArgument(const std::string& arg, const CompileOptions& opts)
+{
+    if (arg == opts.sourcePath ||
+        std::find(opts.moduleInputs.begin(), opts.moduleInputs.end(), arg) != opts.moduleInputs.end()) {
+        return true;
+    }
+    return arg == "--time" || arg == "-c" || arg == "-S" || arg == "--emit-bc" ||
+           arg == "--cache" || arg.compare(0, 8, "--cache=") == 0 || arg.compare(0, 13, "--cache-size=") == 0 ||
+           arg == "--incremental" || arg.compare(0, 14, "--incremental=") == 0;
+}
+
+std::string compilerFingerprint(int argc, char **argv, const CompileOptions& opts, TargetMachine& tm)
+{
+    std::string key = std::string(kCacheFormat) + "\n" + LLVM_VERSION_STRING + "\n";
+
+    // bosojowo yang di-build ulang dianggap compiler yang berbeda
+    struct stat self;
+    if (stat("/proc/self/exe", &self) == 0) {
+        key += std::to_string((long long)self.st_size) + " " + std::to_string((long long)self.st_mtime) + "\n";
+    }
+
+    key += tm.getTargetTriple().str() + "\n" + tm.getTargetCPU().str() + "\n" +
+           tm.getTargetFeatureString().str() + "\n";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o") {
+            i++;
+            continue;
+        }
+        if (!ignoredCacheArgument(arg, opts)) {
+            key += arg + "\n";
+        }
+    }
+    return key;
+}
+
+std::string hashFileContents(const std::string& path)
+{
+    std::string contents;
+    if (!readFile(path, contents)) {
+        return "";
+    }
+    return hashHex(contents);
+}
+
+std::string compileCacheKey(int argc, char **argv, const CompileOptions& opts, TargetMachine& tm)
+{
+    if (opts.sourcePath.empty()) {
+        return "";
+    }
+
+    std::string key = compilerFingerprint(argc, argv, opts, tm);
+
+    std::vector<std::string> inputs(1, opts.sourcePath);
+    inputs.insert(inputs.end(), opts.moduleInputs.begin(), opts.moduleInputs.end());
+    if (!opts.profileUse.empty()) {
+        inputs.push_back(opts.profileUse);
+    }
+    for (const std::string& input : inputs) {
+        std::string hash = hashFileContents(input);
+        if (hash.empty()) {
+            return "";
+        }
+        key += hash + "\n";
+    }
+
+    return hashHex(key);
+}
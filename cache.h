@@ -0,0 +1,67 @@
+#ifndef BOSOJOWO_CACHE_H
+#define BOSOJOWO_CACHE_H
+
+#include <stdint.h>
+#include <string>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+/**
+ * Cache hasil kompilasi di disk, content-addressed: nama entri adalah hash
+ * input, jadi entri tidak pernah di-update, hanya ditulis atau dihapus.
+ *
+ * Aman dipakai beberapa proses sekaligus tanpa lock untuk baca/tulis:
+ * entri ditulis ke file sementara lalu di-rename, pembaca hanya pernah melihat
+ * file yang lengkap, dan file yang sudah dibuka tetap terbaca walaupun dihapus.
+ * Eviction (LRU dari mtime, di-touch setiap kali dibaca) dipegang satu proses
+ * lewat flock pada `DIR/lock`; setelah total ukuran melewati batas, entri
+ * tertua dihapus sampai 90% batas.
+ */
+class CompileCache {
+    std::string dir;
+    uint64_t maxBytes;
+
+    void evict();
+
+public:
+    CompileCache(const std::string& dir, uint64_t maxBytes);
+
+    const std::string& directory() const { return dir; }
+
+    /* Isi entri `name`, false apabila belum ada. */
+    bool load(const std::string& name, std::string& data);
+    bool save(const std::string& name, llvm::StringRef data);
+
+    /* Seperti load/save tapi dari/ke file, mis. output -o. */
+    bool loadToFile(const std::string& name, const std::string& path);
+    bool saveFile(const std::string& name, const std::string& path);
+};
+
+/* `$BOSOJOWO_CACHE`, `$XDG_CACHE_HOME/bosojowo` atau `~/.cache/bosojowo`. */
+std::string defaultCacheDirectory();
+
+/* MD5 dalam hex. */
+std::string hashHex(llvm::StringRef data);
+
+/* MD5 isi file dalam hex, kosong apabila file tidak bisa dibaca. */
+std::string hashFileContents(const std::string& path);
+
+/**
+ * Bagian key yang tidak tergantung input: versi LLVM dan identitas executable
+ * bosojowo, triple/CPU/fitur TargetMachine, dan semua argumen selain nama input
+ * dan output. Belum di-hash, dipakai juga oleh --incremental.
+ */
+std::string compilerFingerprint(int argc, char **argv, const CompileOptions& opts, llvm::TargetMachine& tm);
+
+/**
+ * Key --cache untuk satu kompilasi: compilerFingerprint ditambah isi source dan
+ * input .bc/.profdata. Jenis output tidak termasuk;
+ * object dan bitcode disimpan sebagai `KEY.o` dan `KEY.bc`.
+ * Kosong apabila input tidak bisa di-hash (source dari stdin).
+ */
+std::string compileCacheKey(int argc, char **argv, const CompileOptions& opts, llvm::TargetMachine& tm);
+
+#endif
@@ -1,24 +1,68 @@
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
 #include "node.h"
 #include "codegen.h"
 #include "parser.hpp"
 #include "stringutil.h"
+#include "target.h"
+#include "jit.h"
+#include "specialize.h"
 
 using namespace std;
 
 Value* ensureValue(Value* valOrPtr, BasicBlock* block){
+    if (valOrPtr == nullptr) {
+        return nullptr;
+    }
     if (valOrPtr->getType()->isPointerTy()) {
         return new LoadInst(valOrPtr, "", false, block);
     }
     return valOrPtr;
 }
 
-CodeGenContext::CodeGenContext(){
+/**
+ * Baca target dispatch `panas`. Atomic (monotonic) karena resolver bisa
+ * menulisnya dari thread lain; di x86-64 tetap satu mov biasa.
+ */
+static LoadInst* loadDispatchTarget(GlobalVariable *target, const Twine& name, BasicBlock *block)
+{
+    LoadInst *load = new LoadInst(target, name, false, block);
+    load->setAlignment(block->getParent()->getParent()->getDataLayout().getPointerABIAlignment());
+    load->setAtomic(Monotonic);
+    return load;
+}
+
+CodeGenContext::CodeGenContext(const CompileOptions& options, TargetMachine *targetMachine) :
+    options(options), targetMachine(targetMachine) {
 
     module = new Module("main", getGlobalContext());
 
+    if (!options.profileUse.empty()) {
+        ErrorOr<std::unique_ptr<IndexedInstrProfReader> > reader =
+            IndexedInstrProfReader::create(options.profileUse);
+        if (!reader) {
+            error("cannot read profile " + options.profileUse + ": " + reader.getError().message());
+        }else{
+            profileReader = std::move(*reader);
+        }
+    }
 }
 
 
+/* Apakah ada statement top level selain deklarasi fungsi. */
+static bool hasTopLevelCode(NBlock& root)
+{
+    for (NStatement *stmt : root.statements) {
+        if (dynamic_cast<NFunctionDeclaration*>(stmt) == nullptr &&
+            dynamic_cast<NExternDeclaration*>(stmt) == nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /* Compile the AST into a module */
 void CodeGenContext::generateCode(NBlock& root)
 {
@@ -31,7 +75,11 @@ void CodeGenContext::generateCode(NBlock& root)
     vector<Type*> _argTypes;
     ArrayRef<Type*> argTypes(_argTypes);
 
-    module->setTargetTriple("x86_64-apple-darwin14.5.0");
+    configureModuleForTarget(*module, *targetMachine);
+
+    if (options.debugLevel != DebugNone) {
+        debug.reset(new DebugInfo(*module, options));
+    }
 
 
     std::vector<Type*> putsArgs;
@@ -50,7 +98,10 @@ void CodeGenContext::generateCode(NBlock& root)
         Constant* printfFunc = module->getOrInsertFunction("printf", fTy);
 
         FunctionType* fTy2 = FunctionType::get(Type::getVoidTy(context), argsRef, false);
-        Function* tampilFunc = Function::Create(fTy2, GlobalValue::PrivateLinkage, "weruhi", module);
+        // -flto=thin: satu definisi dipakai bersama oleh semua file
+        GlobalValue::LinkageTypes tampilLinkage = options.thinLTO ? GlobalValue::LinkOnceODRLinkage
+                                                                  : GlobalValue::PrivateLinkage;
+        Function* tampilFunc = Function::Create(fTy2, tampilLinkage, "weruhi", module);
 
         BasicBlock *bblock = BasicBlock::Create(context, "entry", tampilFunc, 0);
 
@@ -87,10 +138,33 @@ void CodeGenContext::generateCode(NBlock& root)
 
     /* Push a new variable/block context */
     pushBlock(bblock);
+    copyLocals(inheritedLocals);
+    localVarDecs() = inheritedVarDecls;
+    if (debug) {
+        debug->beginFunction(mainFunction, 1);
+    }
+    beginFunctionProfile(*this, mainFunction);
     root.codeGen(*this); /* emit bytecode for the toplevel block */
-    ReturnInst::Create(context, bblock);
+    ReturnInst::Create(context, currentBlock());
+    endFunctionProfile(*this);
+    if (debug) {
+        debug->setLocations(mainFunction, root.statements.empty() ? 1 : root.statements.back()->line);
+        debug->endFunction();
+    }
     popBlock();
 
+    // -flto=thin: file yang hanya berisi fungsi tidak punya `main`
+    if (options.thinLTO && !hasTopLevelCode(root)) {
+        mainFunction->eraseFromParent();
+        mainFunction = nullptr;
+    }
+
+    finishModuleProfile(*this);
+    setFunctionTargetAttributes(*module, *targetMachine);
+    if (debug) {
+        debug->finalize();
+    }
+
     /* Print the bytecode in a human-readable format
      to see if our program compiled properly
      */
@@ -102,35 +176,77 @@ void CodeGenContext::generateCode(NBlock& root)
     //    const string banner = "-banner-";
     //    llvm::raw_ostream* os = &outs();
 
-    pm.add(llvm::createPrintModulePass(outs()));
-
-    pm.run(*module);
+    // --jalan: stdout milik program
+    if (!options.run) {
+        pm.add(llvm::createPrintModulePass(outs()));
+        pm.run(*module);
+    }
 
 }
 
-/* Executes the AST by running the main function */
-GenericValue CodeGenContext::runCode() {
+/* Tambahkan module ke JIT lalu panggil `main`. */
+template <typename JIT>
+static int runMain(JIT& jit, std::unique_ptr<Module> module)
+{
+    jit.addModule(std::move(module));
 
-    InitializeNativeTarget();
+    uint64_t address = jit.getAddress("main");
+    if (address == 0) {
+        std::cerr << "error: main was not compiled" << std::endl;
+        return 2;
+    }
 
-    //     LLVMContext Context;
+    void (*entry)() = (void (*)())(intptr_t)address;
+    entry();
+    fflush(stdout);
 
-    // Create some module to put our function into it.
-    std::unique_ptr<Module> Owner = llvm::make_unique<Module>("test", getGlobalContext());
-    Module *M = Owner.get();
+    return 0;
+}
 
-    ExecutionEngine* EE = EngineBuilder(std::move(Owner)).create();
+/**
+ * Simpan salinan module apabila program memakai `khusus()`, dipanggil sebelum
+ * optimasi: fungsi generiknya mungkin sudah di-inline atau dibuang setelahnya.
+ */
+void CodeGenContext::keepSpecializeSource()
+{
+    if (module->getFunction("jowo_khusus") != nullptr) {
+        std::unique_ptr<Module> copy(CloneModule(module));
+        specializeSource = std::move(copy);
+    }
+}
 
-    outs() << "We just constructed this LLVM module:\n\n" << *M;
-    outs() << "\n\nRunning foo: ";
-    outs().flush();
+/**
+ * Jalankan `main` lewat JIT ORC (--jalan). Module diserahkan ke JIT, setelah
+ * ini `module` tidak bisa dipakai lagi. Mengembalikan exit status.
+ */
+int CodeGenContext::runCode() {
 
-    // Call the `foo' function with no arguments:
-    std::vector<GenericValue> noargs;
-    GenericValue gv = EE->runFunction(mainFunction, noargs);
+    if (mainFunction == nullptr) {
+        std::cerr << "error: program has no top level code to run" << std::endl;
+        return 2;
+    }
 
-    return gv;
+    std::unique_ptr<Module> owned(module);
+    module = nullptr;
+    mainFunction = nullptr;
 
+    std::unique_ptr<Specializer> specializer;
+    if (specializeSource) {
+        specializer.reset(new Specializer(*targetMachine, options, std::move(specializeSource)));
+    }
+
+    if (options.lazyJIT) {
+        if (JowoLazyJIT::supports(*targetMachine)) {
+            JowoLazyJIT jit(*targetMachine, options);
+            int status = runMain(jit, std::move(owned));
+            std::cerr << "JIT: " << jit.compiledCount() << " functions compiled" << std::endl;
+            return status;
+        }
+        std::cerr << "warning: --lazy needs an x86-64 host, compiling everything up front" << std::endl;
+    }
+
+    JowoJIT jit(*targetMachine, perfSupport(options));
+    return runMain(jit, std::move(owned));
 }
 
 /* Returns an LLVM type based on the identifier */
@@ -179,35 +295,194 @@ Value* NStr::codeGen(CodeGenContext &context){
 
 }
 
-Value* NMethodCall::codeGen(CodeGenContext& context)
+/**
+ * Generate argumen call. Variabel lokal di-load dulu. false apabila ada
+ * argumen yang gagal di-generate.
+ */
+static bool generateArguments(CodeGenContext& context, ExpressionList::const_iterator begin,
+                              ExpressionList::const_iterator end, std::vector<Value*>& args)
 {
-    Function *function = context.module->getFunction(id.name.c_str());
-    if (function == NULL) {
-        std::cerr << "no such function " << id.name << std::endl;
-    }
-    std::vector<Value*> args;
     ExpressionList::const_iterator it;
-    for (it = arguments.begin(); it != arguments.end(); it++) {
+    for (it = begin; it != end; it++) {
 
         NExpression *exp = (*it);
 
         if (context.localVarDecs().find(exp->key()) != context.localVarDecs().end()){
 //            args.push_back(context.localVarDecs()[exp->key()]->codeGen(context));
 
-            Value* lVal = ensureValue((*exp).codeGen(context), context.currentBlock());
+            Value* lVal = (*exp).codeGen(context);
+            lVal = ensureValue(lVal, context.currentBlock());
             args.push_back(lVal);
 
         }else{
             args.push_back((*exp).codeGen(context));
         }
+        if (args.back() == nullptr) {
+            return false;
+        }
 
 //        std::cout << "exp->kind(): " << exp->key() << std::endl;
 
 
+    }
+    return true;
+}
+
+/**
+ * `khusus(f, a, b, ...)`: minta JIT membuat clone f dengan argumen pertama
+ * diikat ke nilai a, b, ... saat ini. Hasilnya handle (int) yang dipanggil
+ * seperti fungsi dengan argumen sisanya, lihat specialize.h.
+ */
+static Value* generateSpecialize(NMethodCall& call, CodeGenContext& context)
+{
+    if (!context.options.run || context.options.repl) {
+        context.error("khusus() needs --jalan, functions are specialized by the JIT at run time");
+        return nullptr;
+    }
+    if (context.currentFunction != nullptr && context.currentFunction->isPure) {
+        context.error("pure function " + context.currentFunction->id.name + " calls impure function khusus");
+    }
+    std::string name = call.arguments.empty() ? "" : call.arguments[0]->key();
+    Function *generic = name.empty() ? nullptr : context.module->getFunction(name);
+    if (generic == nullptr || generic->isDeclaration()) {
+        context.error("khusus() needs a function defined in this file as its first argument");
+        return nullptr;
+    }
+    unsigned bound = call.arguments.size() - 1;
+    if (bound > generic->arg_size()) {
+        context.error("khusus(): " + name + " takes " + std::to_string(generic->arg_size()) + " arguments");
+        return nullptr;
+    }
+
+    std::vector<Value*> values;
+    if (!generateArguments(context, call.arguments.begin() + 1, call.arguments.end(), values)) {
+        return nullptr;
+    }
+
+    LLVMContext& ctx = getGlobalContext();
+    Type *i64Ty = Type::getInt64Ty(ctx);
+    Type *strTy = Type::getInt8Ty(ctx)->getPointerTo();
+
+    // nilai dikirim sebagai bit i64, slot-nya di entry block supaya tidak tumbuh di dalam loop
+    Function *parent = context.currentBlock()->getParent();
+    IRBuilder<> entryBuilder(&parent->getEntryBlock(), parent->getEntryBlock().begin());
+    Value *slots = entryBuilder.CreateAlloca(i64Ty, ConstantInt::get(Type::getInt32Ty(ctx), bound ? bound : 1),
+                                             "khusus.args");
+
+    IRBuilder<> builder(context.currentBlock());
+    unsigned i = 0;
+    for (Function::arg_iterator arg = generic->arg_begin(); i < bound; arg++, i++) {
+        Value *value = values[i];
+        if (value->getType() != arg->getType()) {
+            context.error("khusus(): argument " + std::to_string(i + 1) + " does not match the parameter type of " + name);
+            return nullptr;
+        }
+        if (value->getType()->isDoubleTy()) {
+            value = builder.CreateBitCast(value, i64Ty);
+        }else if (value->getType()->isPointerTy()) {
+            value = builder.CreatePtrToInt(value, i64Ty);
+        }
+        builder.CreateStore(value, builder.CreateConstGEP1_32(slots, i));
+    }
+
+    std::vector<Type*> params;
+    params.push_back(strTy);
+    params.push_back(i64Ty);
+    params.push_back(i64Ty->getPointerTo());
+    FunctionType *ftype = FunctionType::get(i64Ty, params, false);
+    Constant *specialize = context.module->getOrInsertFunction("jowo_khusus", ftype);
+
+    std::vector<Value*> args;
+    args.push_back(builder.CreateGlobalStringPtr(name, "khusus.name"));
+    args.push_back(ConstantInt::get(i64Ty, bound));
+    args.push_back(slots);
+    std::cout << "Creating specialization: " << name << std::endl;
+    return builder.CreateCall(specialize, args, "handle");
+}
+
+/* Panggil clone hasil `khusus()` lewat handle di variabel lokal. */
+static Value* callSpecialized(NMethodCall& call, CodeGenContext& context, const SpecializedHandle& handle)
+{
+    Function *generic = handle.generic;
+    if (context.currentFunction != nullptr && context.currentFunction->isPure &&
+        context.pureFunctions.find(generic->getName()) == context.pureFunctions.end()) {
+        context.error("pure function " + context.currentFunction->id.name +
+                      " calls impure function " + generic->getName().str());
+    }
+
+    std::vector<Type*> params;
+    unsigned i = 0;
+    for (Function::arg_iterator arg = generic->arg_begin(); arg != generic->arg_end(); arg++, i++) {
+        if (i >= handle.bound) {
+            params.push_back(arg->getType());
+        }
+    }
+    if (call.arguments.size() != params.size()) {
+        context.error(call.id.name + " is " + generic->getName().str() + " specialized, it takes " +
+                      std::to_string(params.size()) + " arguments");
+        return nullptr;
+    }
+
+    std::vector<Value*> args;
+    if (!generateArguments(context, call.arguments.begin(), call.arguments.end(), args)) {
+        return nullptr;
+    }
+
+    Value *address = ensureValue(context.locals()[call.id.name], context.currentBlock());
+    IRBuilder<> builder(context.currentBlock());
+    FunctionType *ftype = FunctionType::get(generic->getReturnType(), params, false);
+    Value *callee = builder.CreateIntToPtr(address, ftype->getPointerTo(), call.id.name + ".target");
+    std::cout << "Creating specialized call: " << call.id.name << std::endl;
+    return builder.CreateCall(callee, args);
+}
+
+/* `h = khusus(f, ...)`: catat f dan jumlah argumen yang diikat untuk panggilan `h(...)`. */
+static void trackSpecializedHandle(CodeGenContext& context, const std::string& variable, NExpression& value)
+{
+    NMethodCall *call = dynamic_cast<NMethodCall*>(&value);
+    if (call == nullptr || call->id.name != "khusus") {
+        return;
+    }
+    SpecializedHandle handle = { context.module->getFunction(call->arguments[0]->key()),
+                                 (unsigned)call->arguments.size() - 1 };
+    context.specializedHandles[variable] = handle;
+}
+
+Value* NMethodCall::codeGen(CodeGenContext& context)
+{
+    if (id.name == "khusus") {
+        return generateSpecialize(*this, context);
+    }
+    Function *function = context.module->getFunction(id.name.c_str());
+    if (function == NULL) {
+        std::map<std::string, SpecializedHandle>::iterator handle = context.specializedHandles.find(id.name);
+        if (handle != context.specializedHandles.end() && context.locals().count(id.name)) {
+            return callSpecialized(*this, context, handle->second);
+        }
+        context.error("no such function " + id.name);
+        return nullptr;
+    }
+    // fungsi murni hanya boleh memanggil fungsi murni lainnya
+    if (context.currentFunction != nullptr && context.currentFunction->isPure &&
+        context.pureFunctions.find(id.name) == context.pureFunctions.end()) {
+        context.error("pure function " + context.currentFunction->id.name +
+                      " calls impure function " + id.name);
+    }
+    std::vector<Value*> args;
+    if (!generateArguments(context, arguments.begin(), arguments.end(), args)) {
+        return nullptr;
     }
     // CallInst *call = CallInst::Create(function, args.begin(), args.end(), "", context.currentBlock());
     ArrayRef<Value*> args2(args);
-    CallInst *call = CallInst::Create(function, args2, "", context.currentBlock());
+
+    // fungsi `panas`: panggil langsung versi yang sudah dipilih resolver
+    Value *callee = function;
+    std::map<std::string, GlobalVariable*>::iterator dispatch = context.dispatchPointers.find(id.name);
+    if (dispatch != context.dispatchPointers.end()) {
+        callee = loadDispatchTarget(dispatch->second, id.name + ".target", context.currentBlock());
+    }
+
+    CallInst *call = CallInst::Create(callee, args2, "", context.currentBlock());
     std::cout << "Creating method call: " << id.name << std::endl;
     return call;
 
@@ -222,14 +497,39 @@ Value* NBinaryOperator::codeGen(CodeGenContext& context)
     std::cout << "Creating binary operation " << op << std::endl;
     Instruction::BinaryOps instr;
 
+    // operand bisa berupa conditional yang memindah current block,
+    // jadi builder dibuat setelah kedua operand di-generate.
+    Value* lval = lhs.codeGen(context);
+    lval = ensureValue(lval, context.currentBlock());
+    Value* rval = rhs.codeGen(context);
+    rval = ensureValue(rval, context.currentBlock());
+    if (lval == nullptr || rval == nullptr) {
+        return nullptr;
+    }
+
     IRBuilder<> builder(context.currentBlock());
 
-    Value* lval = ensureValue(lhs.codeGen(context), context.currentBlock());
-    Value* rval = ensureValue(rhs.codeGen(context), context.currentBlock());
+    // sama dengan --vm: int op int tetap int, campuran dihitung sebagai double
+    Type *lhsTy = lval->getType();
+    Type *rhsTy = rval->getType();
+    if (!(lhsTy->isIntegerTy(64) || lhsTy->isDoubleTy()) || !(rhsTy->isIntegerTy(64) || rhsTy->isDoubleTy())) {
+        context.error("operands of a binary operator must be int or double");
+        return nullptr;
+    }
+    bool ints = lhsTy->isIntegerTy() && rhsTy->isIntegerTy();
+    if (!ints) {
+        Type *doubleTy = Type::getDoubleTy(getGlobalContext());
+        if (lhsTy->isIntegerTy()) {
+            lval = builder.CreateSIToFP(lval, doubleTy);
+        }
+        if (rhsTy->isIntegerTy()) {
+            rval = builder.CreateSIToFP(rval, doubleTy);
+        }
+    }
 
     switch (op) {
         case TPLUS:
-            instr = Instruction::FAdd;
+            instr = ints ? Instruction::Add : Instruction::FAdd;
 
             using namespace std;
 
@@ -239,9 +539,9 @@ Value* NBinaryOperator::codeGen(CodeGenContext& context)
 //            cout << (rhs.codeGen(context)->getType()->isPointerTy() ? "yes" : "no") << endl;
 
             goto math;
-        case TMINUS: instr = Instruction::FSub; goto math;
+        case TMINUS: instr = ints ? Instruction::Sub : Instruction::FSub; goto math;
         case TMUL:
-            instr = Instruction::FMul;
+            instr = ints ? Instruction::Mul : Instruction::FMul;
 //            std::cout << "lhs.kind(): " << lhs.kind() << std::endl;
 ////            context.locals().find(lhs.key())
 //            if (lhs.kind().compare("double") == 0 || rhs.kind().compare("double") == 0) {
@@ -259,13 +559,19 @@ Value* NBinaryOperator::codeGen(CodeGenContext& context)
             goto math;
 
         case TDIV:
-            instr = Instruction::SDiv; goto math;
+            instr = ints ? Instruction::SDiv : Instruction::FDiv; goto math;
 
         case TCLT: // < ( less than )
+            if (ints) {
+                return builder.CreateICmp(CmpInst::Predicate::ICMP_SLT, lval, rval);
+            }
             return builder.CreateFCmp(CmpInst::Predicate::FCMP_OLT, lval, rval);
 
 
         case TCGT: // > ( greater than )
+            if (ints) {
+                return builder.CreateICmp(CmpInst::Predicate::ICMP_SGT, lval, rval);
+            }
             return builder.CreateFCmp(CmpInst::Predicate::FCMP_OGT, lval, rval);
 
             /* TODO comparison */
@@ -287,14 +593,59 @@ math:
 
 }
 
+/**
+ * Nilai sebuah expression (arm conditional, sisi kanan assignment): variabel
+ * lokal (alloca, atau global di repl) di-load dulu, string tetap pointer.
+ */
+static Value* armValue(Value* value, BasicBlock* block)
+{
+    if (value != nullptr && (isa<AllocaInst>(value) || isa<GlobalVariable>(value))) {
+        return new LoadInst(value, "", false, block);
+    }
+    return value;
+}
+
+/**
+ * Tipe nilai variabel lokal: alloca dan global (repl) di-load oleh armValue,
+ * argumen dan variabel loop sudah berupa nilai.
+ */
+static Type* localType(Value* local)
+{
+    if (AllocaInst *alloca = dyn_cast<AllocaInst>(local)) {
+        return alloca->getAllocatedType();
+    }
+    if (GlobalVariable *global = dyn_cast<GlobalVariable>(local)) {
+        return global->getType()->getElementType();
+    }
+    return local->getType();
+}
+
 Value* NAssignment::codeGen(CodeGenContext& context)
 {
     std::cout << "Creating assignment for " << lhs.name << std::endl;
     if (context.locals().find(lhs.name) == context.locals().end()) {
-        std::cerr << "undeclared variable " << lhs.name << std::endl;
+        context.error("undeclared variable " + lhs.name);
+        return NULL;
+    }
+    // fungsi murni hanya boleh mengubah variabel lokalnya sendiri (alloca di fungsi ini)
+    if (context.currentFunction != nullptr && context.currentFunction->isPure) {
+        AllocaInst *local = dyn_cast<AllocaInst>(context.locals()[lhs.name]);
+        if (local == nullptr || local->getParent()->getParent() != context.currentBlock()->getParent()) {
+            context.error("pure function " + context.currentFunction->id.name +
+                          " assigns to non-local variable " + lhs.name);
+            return NULL;
+        }
+    }
+    Value* value = armValue(rhs.codeGen(context), context.currentBlock());
+    if (value == nullptr) {
         return NULL;
     }
-    return new StoreInst(rhs.codeGen(context), context.locals()[lhs.name], true, context.currentBlock());
+    // int ke variabel double dinaikkan, sama dengan --vm
+    if (value->getType()->isIntegerTy(64) && localType(context.locals()[lhs.name])->isDoubleTy()) {
+        value = new SIToFPInst(value, Type::getDoubleTy(getGlobalContext()), "", context.currentBlock());
+    }
+    trackSpecializedHandle(context, lhs.name, rhs);
+    return new StoreInst(value, context.locals()[lhs.name], true, context.currentBlock());
 }
 
 Value* NBlock::codeGen(CodeGenContext& context)
@@ -303,12 +654,87 @@ Value* NBlock::codeGen(CodeGenContext& context)
     Value *last = NULL;
     for (it = statements.begin(); it != statements.end(); it++) {
         //std::cout << "Generating code for " << typeid(**it).name() << std::endl;
+        DebugInfo::Mark mark = { nullptr, nullptr };
+        if (context.debug) {
+            mark = context.debug->mark(context.currentBlock());
+        }
         last = (**it).codeGen(context);
+        if (context.debug) {
+            // statement bersarang sudah diberi barisnya sendiri lebih dulu
+            context.debug->setLocations(mark, (**it).line);
+        }
     }
     std::cout << "Creating block" << std::endl;
     return last;
 }
 
+// arm yang lebih mahal dari ini tetap memakai cabang
+static const int kMaxSelectArmCost = 4;
+
+int NBinaryOperator::speculationCost()
+{
+    // pembagian bisa trap, jangan dieksekusi spekulatif
+    if (op == TDIV) {
+        return -1;
+    }
+    int lhsCost = lhs.speculationCost();
+    int rhsCost = rhs.speculationCost();
+    if (lhsCost < 0 || rhsCost < 0) {
+        return -1;
+    }
+    return lhsCost + rhsCost + 1;
+}
+
+int NBlock::speculationCost()
+{
+    if (statements.size() != 1) {
+        return -1;
+    }
+    return statements[0]->speculationCost();
+}
+
+/**
+ * Tipe hasil arm yang bisa dispekulasi (speculationCost >= 0), dari AST saja,
+ * tanpa meng-generate IR. nullptr apabila tidak diketahui.
+ */
+static Type* speculatedType(NExpression& expr, CodeGenContext& context)
+{
+    LLVMContext& ctx = getGlobalContext();
+    if (NBlock *block = dynamic_cast<NBlock*>(&expr)) {
+        return block->statements.size() == 1 ? speculatedType(*block->statements[0], context) : nullptr;
+    }
+    if (NExpressionStatement *statement = dynamic_cast<NExpressionStatement*>(&expr)) {
+        return speculatedType(statement->expression, context);
+    }
+    if (dynamic_cast<NInteger*>(&expr)) {
+        return Type::getInt64Ty(ctx);
+    }
+    if (dynamic_cast<NDouble*>(&expr)) {
+        return Type::getDoubleTy(ctx);
+    }
+    if (dynamic_cast<NStr*>(&expr)) {
+        return Type::getInt8PtrTy(ctx);
+    }
+    if (NIdentifier *ident = dynamic_cast<NIdentifier*>(&expr)) {
+        std::map<std::string, Value*>::iterator local = context.locals().find(ident->name);
+        return local != context.locals().end() ? localType(local->second) : nullptr;
+    }
+    if (NBinaryOperator *binary = dynamic_cast<NBinaryOperator*>(&expr)) {
+        // sama dengan NBinaryOperator::codeGen: int op int tetap int, campuran jadi double
+        Type *lhsTy = speculatedType(binary->lhs, context);
+        Type *rhsTy = speculatedType(binary->rhs, context);
+        if (lhsTy == nullptr || rhsTy == nullptr ||
+            !(lhsTy->isIntegerTy(64) || lhsTy->isDoubleTy()) || !(rhsTy->isIntegerTy(64) || rhsTy->isDoubleTy())) {
+            return nullptr;
+        }
+        if (binary->op == TCLT || binary->op == TCGT) {
+            return Type::getInt1Ty(ctx);
+        }
+        return lhsTy == rhsTy ? lhsTy : Type::getDoubleTy(ctx);
+    }
+    return nullptr;
+}
+
 Value* NConditionalBlock::codeGen(CodeGenContext& context)
 {
 
@@ -320,56 +746,112 @@ Value* NConditionalBlock::codeGen(CodeGenContext& context)
         return nullptr;
     }
 
-
-    IRBuilder<> builder(context.currentBlock());
+    // arm kecil tanpa efek samping dengan tipe yang sama: evaluasi keduanya lalu
+    // pilih dengan `select`, tanpa cabang. Diputuskan dari AST sebelum IR arm dibuat.
+    if (context.options.selectConditionals) {
+        int thenCost = thenStmt->speculationCost();
+        int elseCost = elseStmt->speculationCost();
+        Type *armTy = nullptr;
+        if (thenCost >= 0 && thenCost <= kMaxSelectArmCost &&
+            elseCost >= 0 && elseCost <= kMaxSelectArmCost) {
+            armTy = speculatedType(*thenStmt, context);
+            if (armTy != speculatedType(*elseStmt, context)) {
+                armTy = nullptr;
+            }
+        }
+        if (armTy != nullptr) {
+            Value *thenV = armValue(thenStmt->codeGen(context), context.currentBlock());
+            Value *elseV = armValue(elseStmt->codeGen(context), context.currentBlock());
+            if (thenV == nullptr || elseV == nullptr) {
+                return nullptr;
+            }
+            std::cout << "Creating select" << std::endl;
+            IRBuilder<> builder(context.currentBlock());
+            return builder.CreateSelect(condCode, thenV, elseV, "iftmp");
+        }
+    }
 
     Function *theFunction = context.currentBlock()->getParent();
 
-//    condCode->setName("ifcond");
     BasicBlock *thenBB = BasicBlock::Create(getGlobalContext(), "then", theFunction);
     BasicBlock *elseBB = BasicBlock::Create(getGlobalContext(), "else");
-//    BasicBlock *mergeBB = BasicBlock::Create(getGlobalContext(), "ifcont");
-
-    BranchInst::Create(thenBB, elseBB, condCode, context.currentBlock());
-//    builder.CreateCondBr(condCode, thenBB, elseBB);
+    BasicBlock *mergeBB = BasicBlock::Create(getGlobalContext(), "ifcont");
 
+    BranchInst *branch = BranchInst::Create(thenBB, elseBB, condCode, context.currentBlock());
 
     // get locals
     std::map<std::string, Value*>& parentLocals = context.locals();
 
     context.pushBlock(thenBB);
     context.copyLocals(parentLocals); // copy local dari parent-nya ke current block
-
-    builder.SetInsertPoint(thenBB);
+    unsigned thenRegion = profileRegion(context, thenBB, RegionThen);
 
     Value *thenV = thenStmt->codeGen(context);
-    if (!thenV)
-        return nullptr;
+    thenV = armValue(thenV, context.currentBlock());
+
+    // arm bisa berakhir di block lain (conditional/loop bersarang)
+    BasicBlock *thenEndBB = context.currentBlock();
+    bool thenFalls = thenEndBB->getTerminator() == nullptr;
+    if (thenFalls) {
+        BranchInst::Create(mergeBB, thenEndBB);
+    }
 
     context.popBlock();
 
     theFunction->getBasicBlockList().push_back(elseBB);
     context.pushBlock(elseBB);
     context.copyLocals(parentLocals);
+    unsigned elseRegion = profileRegion(context, elseBB, RegionElse);
+    profileBranch(context, branch, thenRegion, elseRegion, false);
 
-    builder.SetInsertPoint(elseBB);
-    Value* elseV = elseStmt->codeGen(context);
-    if (!elseV) {
-        return nullptr;
+    Value *elseV = elseStmt->codeGen(context);
+    elseV = armValue(elseV, context.currentBlock());
+
+    BasicBlock *elseEndBB = context.currentBlock();
+    bool elseFalls = elseEndBB->getTerminator() == nullptr;
+    if (elseFalls) {
+        BranchInst::Create(mergeBB, elseEndBB);
     }
 
     context.popBlock();
 
+    // kedua arm sudah `nyoh`, tidak ada yang sampai ke merge block
+    if (!thenFalls && !elseFalls) {
+        delete mergeBB;
+        return nullptr;
+    }
+
+    theFunction->getBasicBlockList().push_back(mergeBB);
+    context.setCurrentBlock(mergeBB);
+
+    // conditional sebagai expression: nilai dari kedua arm digabung lewat PHI
+    if (thenFalls && elseFalls && thenV && elseV &&
+        thenV->getType() == elseV->getType() && !thenV->getType()->isVoidTy()) {
+        PHINode *phi = PHINode::Create(thenV->getType(), 2, "iftmp", mergeBB);
+        phi->addIncoming(thenV, thenEndBB);
+        phi->addIncoming(elseV, elseEndBB);
+        return phi;
+    }
 
     return nullptr;
 
 }
 
 
+/* Batas `muter` selalu double seperti di --vm: variabel di-load, int dinaikkan ke double. */
+static Value* loopBound(Value* value, BasicBlock* block)
+{
+    value = ensureValue(value, block);
+    if (value != nullptr && value->getType()->isIntegerTy()) {
+        return new SIToFPInst(value, Type::getDoubleTy(getGlobalContext()), "", block);
+    }
+    return value;
+}
+
 Value* NLoop::codeGen(CodeGenContext& context)
 {
 
-    Value *fromCode = exprFrom.codeGen(context);
+    Value *fromCode = loopBound(exprFrom.codeGen(context), context.currentBlock());
 
     std::cout << "exprFrom.kind(): " << exprFrom.kind() << std::endl;
 
@@ -397,18 +879,24 @@ Value* NLoop::codeGen(CodeGenContext& context)
     PHINode* Variable = PHINode::Create(doubleTy, 2, "i", loopBlock);
     Variable->addIncoming(fromCode, preHeaderBB);
     context.locals()["i"] = Variable;
+    if (context.debug) {
+        context.debug->declareValue(Variable, "i", line, 0, loopBlock);
+    }
+    unsigned bodyRegion = profileRegion(context, loopBlock, RegionLoopBody);
 
     this->block->codeGen(context);
 
     builder.CreateBr(loopBlock);
-    builder.SetInsertPoint(loopBlock);
+
+    // body bisa berakhir di block lain (mis. merge block dari `nek`)
+    builder.SetInsertPoint(context.currentBlock());
 
 
 //    AllocaInst *alloc = new AllocaInst(doubleTy, "i", context.currentBlock());
 //    context.locals()["i"] = alloc;
 
 
-    Value* exprUntilCode = exprUntil.codeGen(context);
+    Value* exprUntilCode = loopBound(exprUntil.codeGen(context), context.currentBlock());
 
     Value* nextVar = builder.CreateFAdd(Variable, ConstantFP::get(getGlobalContext(), APFloat(1.0)), "nextvar");
 
@@ -418,18 +906,18 @@ Value* NLoop::codeGen(CodeGenContext& context)
 
     Value* compareV = builder.CreateFCmpOLE(nextVar, exprUntilCode, "loopcond");
 
-    builder.CreateCondBr(compareV, loopBlock, afterBB);
+    BranchInst *branch = builder.CreateCondBr(compareV, loopBlock, afterBB);
 
     Variable->addIncoming(nextVar, loopEndBB);
 
-    context.popBlock();
+    unsigned exitRegion = profileRegion(context, afterBB, RegionLoopExit);
+    profileBranch(context, branch, bodyRegion, exitRegion, true);
 
-    // void return
-    context.pushBlock(afterBB);
-    builder.SetInsertPoint(afterBB);
-    Value* returnInst = ReturnInst::Create(getGlobalContext(), nullptr, context.currentBlock());
     context.popBlock();
 
+    // statement berikutnya dilanjutkan setelah loop
+    context.setCurrentBlock(afterBB);
+
     return nullptr;
 
 }
@@ -445,7 +933,7 @@ Value* NIdentifier::codeGen(CodeGenContext& context)
 {
     std::cout << "Creating identifier reference: " << name << std::endl;
     if (context.locals().find(name) == context.locals().end()) {
-        std::cerr << "undeclared variable " << name << std::endl;
+        context.error("undeclared variable " + name);
         return NULL;
     }
     //    if (!context.locals()[name]->isUsedInBasicBlock(context.currentBlock())){
@@ -461,7 +949,18 @@ Value* NVariableDeclaration::codeGen(CodeGenContext& context)
     std::cout << "Creating variable declaration " << type.name << " " << id.name << std::endl;
 
     if (assignmentExpr != NULL){
-        AllocaInst *alloc = new AllocaInst(typeOf(type), id.name.c_str(), context.currentBlock());
+        Value *alloc;
+        if (context.options.repl && context.currentFunction == nullptr) {
+            // repl: variabel top level jadi global supaya terlihat di entri berikutnya
+            alloc = new GlobalVariable(*context.module, typeOf(type), false, GlobalValue::ExternalLinkage,
+                                       Constant::getNullValue(typeOf(type)), id.name);
+        }else{
+            AllocaInst *local = new AllocaInst(typeOf(type), id.name.c_str(), context.currentBlock());
+            if (context.debug) {
+                context.debug->declareVariable(local, id.name, line, context.currentBlock());
+            }
+            alloc = local;
+        }
         context.locals()[id.name] = alloc;
         if (assignmentExpr != NULL) {
             NAssignment assn(id, *assignmentExpr);
@@ -481,22 +980,11 @@ Value* NVariableDeclaration::codeGen(CodeGenContext& context)
 }
 
 
-Value* NFunctionDeclaration::codeGen(CodeGenContext& context)
+/**
+ * Isi body fungsi: argumen dimasukkan ke locals lalu block di-generate.
+ */
+static void generateFunctionBody(CodeGenContext& context, NFunctionDeclaration& decl, Function *function)
 {
-    vector<Type*> _argTypes;
-    VariableList::const_iterator it;
-    for (it = arguments.begin(); it != arguments.end(); it++) {
-        _argTypes.push_back(typeOf((**it).type));
-    }
-
-    ArrayRef<Type*> argTypes(_argTypes);
-
-    FunctionType *ftype = FunctionType::get(Type::getVoidTy(getGlobalContext()), argTypes, false);
-    if (this->type != nullptr) {
-        ftype = FunctionType::get(typeOf(*type), argTypes, false);
-    }
-    Function *function = Function::Create(ftype, GlobalValue::InternalLinkage, id.name.c_str(), context.module);
-
     BasicBlock *bblock = BasicBlock::Create(getGlobalContext(), "entry", function, 0);
 
     context.pushBlock(bblock);
@@ -504,7 +992,7 @@ Value* NFunctionDeclaration::codeGen(CodeGenContext& context)
     // setting arguments-name
     // masukkan setiap var args ke context.locals untuk diproses kemudian oleh block.
     {
-        VariableList::const_iterator argIt = arguments.begin();
+        VariableList::const_iterator argIt = decl.arguments.begin();
         Function::arg_iterator it = function->arg_begin();
 
         for (it = function->arg_begin(); it != function->arg_end(); it++) {
@@ -524,11 +1012,11 @@ Value* NFunctionDeclaration::codeGen(CodeGenContext& context)
 
     // periksa apakah di dalam block sudah ada return statement
     // apabila belum ada maka perlu menambahkan void return.
-    StatementList::iterator s_it = block.statements.begin();
+    StatementList::iterator s_it = decl.block.statements.begin();
     vector<NStatement*> nStatements;
 
     bool hasReturn = false;
-    for (s_it = block.statements.begin(); s_it != block.statements.end(); s_it++){
+    for (s_it = decl.block.statements.begin(); s_it != decl.block.statements.end(); s_it++){
         std::cout << "s_it: " << (*s_it)->kind() << std::endl;
         if ((*s_it)->kind() == "Return") {
             hasReturn = true;
@@ -540,17 +1028,441 @@ Value* NFunctionDeclaration::codeGen(CodeGenContext& context)
     }
 
     // hanya apabila tidak memiliki return dan type func-nya adalah void.
-    if (!hasReturn && ftype->getReturnType()->isVoidTy()){
+    if (!hasReturn && function->getReturnType()->isVoidTy()){
         // apabila tidak memiliki return
         // buatkan void return.
         //if (block.statements.size() == 0){
-            block.statements.push_back(new NReturn());
+            NReturn *ret = new NReturn();
+            ret->line = decl.block.statements.empty() ? decl.line : decl.block.statements.back()->line;
+            decl.block.statements.push_back(ret);
         //}
     }
 
-    block.codeGen(context);
+    NFunctionDeclaration *outer = context.currentFunction;
+    context.currentFunction = &decl;
+    if (context.debug) {
+        context.debug->beginFunction(function, decl.line);
+        unsigned argNo = 1;
+        for (Function::arg_iterator it = function->arg_begin(); it != function->arg_end(); it++, argNo++) {
+            context.debug->declareValue(&*it, it->getName(), decl.line, argNo, bblock);
+        }
+    }
+    beginFunctionProfile(context, function);
+    decl.block.codeGen(context);
+    endFunctionProfile(context);
+    if (context.debug) {
+        context.debug->endFunction();
+    }
+    context.currentFunction = outer;
 
     context.popBlock();
+}
+
+/**
+ * Bungkus fungsi murni `impl` dengan cache memo open-addressing.
+ *
+ * Setiap fungsi punya tabel global sendiri berisi entri { key argumen (bit i64),
+ * hasil, flag terisi }. Slot awal diambil dari hash bit argumen lalu dicari
+ * secara linear sebanyak `memoProbes` slot. Apabila semua slot terisi key lain,
+ * kebijakan eviction menentukan apakah slot asal ditimpa atau hasil tidak disimpan.
+ */
+static void generateMemoWrapper(CodeGenContext& context, Function *wrapper, Function *impl)
+{
+    LLVMContext& ctx = getGlobalContext();
+    const CompileOptions& opts = context.options;
+
+    Type *i8Ty = Type::getInt8Ty(ctx);
+    Type *i32Ty = Type::getInt32Ty(ctx);
+    Type *i64Ty = Type::getInt64Ty(ctx);
+    Type *retTy = wrapper->getReturnType();
+    unsigned numArgs = wrapper->arg_size();
+
+    std::vector<Type*> fields;
+    fields.push_back(ArrayType::get(i64Ty, numArgs));
+    fields.push_back(retTy);
+    fields.push_back(i8Ty);
+    StructType *entryTy = StructType::get(ctx, fields);
+    ArrayType *tableTy = ArrayType::get(entryTy, opts.memoCapacity);
+
+    GlobalVariable *table = new GlobalVariable(*context.module, tableTy, false,
+                                               GlobalValue::InternalLinkage,
+                                               ConstantAggregateZero::get(tableTy),
+                                               wrapper->getName() + ".memo");
+
+    BasicBlock *entryBB = BasicBlock::Create(ctx, "entry", wrapper);
+    IRBuilder<> builder(entryBB);
+
+    // hash FNV-1a dari bit setiap argumen
+    std::vector<Value*> args;
+    std::vector<Value*> keys;
+    Value *hash = ConstantInt::get(i64Ty, 0xcbf29ce484222325ULL);
+    for (Function::arg_iterator it = wrapper->arg_begin(); it != wrapper->arg_end(); it++) {
+        Value *arg = &*it;
+        Value *bits = arg->getType()->isDoubleTy() ? builder.CreateBitCast(arg, i64Ty) : arg;
+        args.push_back(arg);
+        keys.push_back(bits);
+        hash = builder.CreateMul(builder.CreateXor(hash, bits), ConstantInt::get(i64Ty, 0x100000001b3ULL));
+    }
+    hash = builder.CreateXor(hash, builder.CreateLShr(hash, 32));
+
+    Value *mask = ConstantInt::get(i64Ty, opts.memoCapacity - 1);
+    Value *home = builder.CreateAnd(hash, mask, "home");
+
+    auto entryAt = [&](IRBuilder<>& b, Value *slot) -> Value* {
+        Value *idx[] = { ConstantInt::get(i64Ty, 0), slot };
+        return b.CreateGEP(table, idx, "entry");
+    };
+    auto keyAt = [&](IRBuilder<>& b, Value *entry, unsigned i) -> Value* {
+        Value *idx[] = { ConstantInt::get(i32Ty, 0), ConstantInt::get(i32Ty, 0), ConstantInt::get(i32Ty, i) };
+        return b.CreateGEP(entry, idx);
+    };
+
+    BasicBlock *hitBB = BasicBlock::Create(ctx, "memo.hit", wrapper);
+    BasicBlock *missBB = BasicBlock::Create(ctx, "memo.miss", wrapper);
+
+    IRBuilder<> hitBuilder(hitBB);
+    PHINode *hitEntry = hitBuilder.CreatePHI(entryTy->getPointerTo(), opts.memoProbes, "hit.entry");
+    hitBuilder.CreateRet(hitBuilder.CreateLoad(hitBuilder.CreateStructGEP(entryTy, hitEntry, 1)));
+
+    IRBuilder<> missBuilder(missBB);
+    PHINode *missSlot = missBuilder.CreatePHI(i64Ty, opts.memoProbes + 1, "miss.slot");
+
+    for (unsigned k = 0; k < opts.memoProbes; k++) {
+        Value *slot = home;
+        if (k > 0) {
+            slot = builder.CreateAnd(builder.CreateAdd(home, ConstantInt::get(i64Ty, k)), mask);
+        }
+        Value *entry = entryAt(builder, slot);
+        Value *used = builder.CreateLoad(builder.CreateStructGEP(entryTy, entry, 2), "used");
+
+        // slot kosong: hitung dan simpan di slot ini
+        BasicBlock *checkBB = BasicBlock::Create(ctx, "memo.check", wrapper);
+        missSlot->addIncoming(slot, builder.GetInsertBlock());
+        builder.CreateCondBr(builder.CreateICmpEQ(used, ConstantInt::get(i8Ty, 0)), missBB, checkBB);
+
+        // slot terisi: bandingkan semua key
+        builder.SetInsertPoint(checkBB);
+        Value *same = ConstantInt::getTrue(ctx);
+        for (unsigned i = 0; i < numArgs; i++) {
+            Value *key = builder.CreateLoad(keyAt(builder, entry, i));
+            same = builder.CreateAnd(same, builder.CreateICmpEQ(key, keys[i]));
+        }
+
+        BasicBlock *nextBB = BasicBlock::Create(ctx, "memo.next", wrapper);
+        hitEntry->addIncoming(entry, checkBB);
+        builder.CreateCondBr(same, hitBB, nextBB);
+        builder.SetInsertPoint(nextBB);
+    }
+
+    // semua slot probe sudah terisi key lain
+    if (opts.memoEviction == MemoEvictReplace) {
+        missSlot->addIncoming(home, builder.GetInsertBlock());
+    }else{
+        missSlot->addIncoming(ConstantInt::get(i64Ty, -1, true), builder.GetInsertBlock());
+    }
+    builder.CreateBr(missBB);
+
+    Value *result = missBuilder.CreateCall(impl, args, "result");
+
+    BasicBlock *storeBB = missBB;
+    if (opts.memoEviction == MemoEvictKeep) {
+        storeBB = BasicBlock::Create(ctx, "memo.store", wrapper);
+        BasicBlock *doneBB = BasicBlock::Create(ctx, "memo.done", wrapper);
+        missBuilder.CreateCondBr(missBuilder.CreateICmpSGE(missSlot, ConstantInt::get(i64Ty, 0)), storeBB, doneBB);
+        IRBuilder<> doneBuilder(doneBB);
+        doneBuilder.CreateRet(result);
+    }
+
+    IRBuilder<> storeBuilder(storeBB);
+    Value *entry = entryAt(storeBuilder, missSlot);
+    for (unsigned i = 0; i < numArgs; i++) {
+        storeBuilder.CreateStore(keys[i], keyAt(storeBuilder, entry, i));
+    }
+    storeBuilder.CreateStore(result, storeBuilder.CreateStructGEP(entryTy, entry, 1));
+    storeBuilder.CreateStore(ConstantInt::get(i8Ty, 1), storeBuilder.CreateStructGEP(entryTy, entry, 2));
+    storeBuilder.CreateRet(result);
+}
+
+/**
+ * `cpuid` lewat inline asm, hasilnya { eax, ebx, ecx, edx }.
+ */
+static Value* createCpuid(IRBuilder<>& builder, unsigned leaf, unsigned subleaf)
+{
+    LLVMContext& ctx = getGlobalContext();
+    Type *i32Ty = Type::getInt32Ty(ctx);
+    Type *regs[] = { i32Ty, i32Ty, i32Ty, i32Ty };
+    Type *argTys[] = { i32Ty, i32Ty };
+    FunctionType *asmTy = FunctionType::get(StructType::get(ctx, regs), argTys, false);
+    InlineAsm *cpuid = InlineAsm::get(asmTy, "cpuid", "={ax},={bx},={cx},={dx},{ax},{cx}", false);
+    Value *args[] = { ConstantInt::get(i32Ty, leaf), ConstantInt::get(i32Ty, subleaf) };
+    return builder.CreateCall(cpuid, args, "cpuid");
+}
+
+/**
+ * Fungsi `bosojowo.cpu_level`: 0 = baseline x86-64, 1 = AVX2, 2 = AVX-512.
+ * Fitur CPU dan dukungan OS (XCR0) dicek, jadi AVX tidak dipakai apabila
+ * kernel tidak menyimpan register YMM/ZMM.
+ */
+static Function* getCpuLevelFunction(CodeGenContext& context)
+{
+    Function *existing = context.module->getFunction("bosojowo.cpu_level");
+    if (existing != nullptr) {
+        return existing;
+    }
+
+    LLVMContext& ctx = getGlobalContext();
+    Type *i32Ty = Type::getInt32Ty(ctx);
+    FunctionType *ftype = FunctionType::get(i32Ty, false);
+    Function *function = Function::Create(ftype, GlobalValue::InternalLinkage, "bosojowo.cpu_level", context.module);
+
+    BasicBlock *entryBB = BasicBlock::Create(ctx, "entry", function);
+    BasicBlock *xcrBB = BasicBlock::Create(ctx, "xcr", function);
+    BasicBlock *leaf7BB = BasicBlock::Create(ctx, "leaf7", function);
+    BasicBlock *avx2BB = BasicBlock::Create(ctx, "avx2", function);
+    BasicBlock *baselineBB = BasicBlock::Create(ctx, "baseline", function);
+
+    auto bits = [&](IRBuilder<>& b, Value *reg, unsigned mask) -> Value* {
+        return b.CreateICmpEQ(b.CreateAnd(reg, mask), ConstantInt::get(i32Ty, mask));
+    };
+
+    // leaf 1: ECX.OSXSAVE (27) dan ECX.AVX (28)
+    IRBuilder<> builder(entryBB);
+    Value *maxLeaf = builder.CreateExtractValue(createCpuid(builder, 0, 0), 0);
+    Value *ecx1 = builder.CreateExtractValue(createCpuid(builder, 1, 0), 2);
+    Value *hasLeaf7 = builder.CreateICmpUGE(maxLeaf, ConstantInt::get(i32Ty, 7));
+    builder.CreateCondBr(builder.CreateAnd(hasLeaf7, bits(builder, ecx1, (1u << 27) | (1u << 28))), xcrBB, baselineBB);
+
+    // XCR0: OS menyimpan state XMM dan YMM
+    builder.SetInsertPoint(xcrBB);
+    Type *xgetbvRegs[] = { i32Ty, i32Ty };
+    FunctionType *xgetbvTy = FunctionType::get(StructType::get(ctx, xgetbvRegs), i32Ty, false);
+    InlineAsm *xgetbv = InlineAsm::get(xgetbvTy, "xgetbv", "={ax},={dx},{cx}", false);
+    Value *xcr0 = builder.CreateExtractValue(builder.CreateCall(xgetbv, ConstantInt::get(i32Ty, 0)), 0, "xcr0");
+    builder.CreateCondBr(bits(builder, xcr0, 0x6), leaf7BB, baselineBB);
+
+    // leaf 7: EBX.AVX2 (5), EBX.AVX512F (16)
+    builder.SetInsertPoint(leaf7BB);
+    Value *ebx7 = builder.CreateExtractValue(createCpuid(builder, 7, 0), 1);
+    builder.CreateCondBr(bits(builder, ebx7, 1u << 5), avx2BB, baselineBB);
+
+    // AVX-512 juga butuh state opmask dan ZMM di XCR0
+    builder.SetInsertPoint(avx2BB);
+    Value *avx512 = builder.CreateAnd(bits(builder, ebx7, 1u << 16), bits(builder, xcr0, 0xe6));
+    builder.CreateRet(builder.CreateSelect(avx512, ConstantInt::get(i32Ty, 2), ConstantInt::get(i32Ty, 1)));
+
+    builder.SetInsertPoint(baselineBB);
+    builder.CreateRet(ConstantInt::get(i32Ty, 0));
+
+    return function;
+}
+
+/* Versi fungsi `panas`, urut dari level CPU terendah. */
+struct FunctionVariant {
+    const char *suffix;
+    const char *cpu;
+    const char *features;
+};
+
+static const FunctionVariant kHotVariants[] = {
+    { "baseline", "x86-64", "" },
+    { "avx2", "haswell", "+avx2,+fma" },
+    { "avx512", "skx", "+avx512f,+avx512dq,+avx512bw,+avx512vl,+avx2,+fma" },
+};
+
+static const unsigned kNumHotVariants = sizeof(kHotVariants) / sizeof(kHotVariants[0]);
+
+static bool supportsMultiversion(CodeGenContext& context)
+{
+    return Triple(context.module->getTargetTriple()).getArch() == Triple::x86_64;
+}
+
+/**
+ * Buat satu versi body per generasi CPU. Panggilan ke `function` lewat
+ * pointer `<nama>.ptr` yang awalnya menunjuk ke resolver. Resolver memilih
+ * versi terbaik saat panggilan pertama lalu menyimpannya ke pointer, sehingga
+ * panggilan berikutnya hanya satu indirect call (seperti IFUNC/PLT, IR LLVM 3.7
+ * belum punya ifunc). Body di-generate sekali dari AST, versi lain di-clone
+ * lalu hanya atribut CPU-nya yang berbeda.
+ */
+static void generateMultiversion(CodeGenContext& context, NFunctionDeclaration& decl, Function *function)
+{
+    LLVMContext& ctx = getGlobalContext();
+    FunctionType *ftype = function->getFunctionType();
+    std::string name = function->getName();
+
+    Function *resolver = Function::Create(ftype, GlobalValue::InternalLinkage, name + ".resolve", context.module);
+    GlobalVariable *target = new GlobalVariable(*context.module, ftype->getPointerTo(), false,
+                                                GlobalValue::InternalLinkage, resolver, name + ".ptr");
+
+    // daftarkan dulu supaya rekursi di body juga lewat pointer
+    context.dispatchPointers[name] = target;
+
+    Function *versions[kNumHotVariants];
+    versions[0] = Function::Create(ftype, GlobalValue::InternalLinkage, name + "." + kHotVariants[0].suffix, context.module);
+    generateFunctionBody(context, decl, versions[0]);
+    for (unsigned i = 1; i < kNumHotVariants; i++) {
+        ValueToValueMapTy vmap;
+        versions[i] = CloneFunction(versions[0], vmap, false);
+        versions[i]->setName(name + "." + kHotVariants[i].suffix);
+        context.module->getFunctionList().push_back(versions[i]);
+    }
+    for (unsigned i = 0; i < kNumHotVariants; i++) {
+        versions[i]->addFnAttr("target-cpu", kHotVariants[i].cpu);
+        versions[i]->addFnAttr("target-features", kHotVariants[i].features);
+    }
+
+    std::vector<Value*> args;
+
+    // resolver: pilih versi, simpan, lalu teruskan panggilan pertama
+    {
+        for (Function::arg_iterator it = resolver->arg_begin(); it != resolver->arg_end(); it++) {
+            args.push_back(&*it);
+        }
+
+        IRBuilder<> builder(BasicBlock::Create(ctx, "entry", resolver));
+        Value *level = builder.CreateCall(getCpuLevelFunction(context), None, "level");
+        Value *chosen = versions[0];
+        for (unsigned i = 1; i < kNumHotVariants; i++) {
+            Value *supported = builder.CreateICmpUGE(level, ConstantInt::get(Type::getInt32Ty(ctx), i));
+            chosen = builder.CreateSelect(supported, versions[i], chosen);
+        }
+        // thread lain boleh ikut memanggil resolver, hasilnya sama
+        StoreInst *store = builder.CreateStore(chosen, target);
+        store->setAlignment(context.module->getDataLayout().getPointerABIAlignment());
+        store->setAtomic(Monotonic);
+
+        CallInst *call = builder.CreateCall(chosen, args);
+        call->setTailCall();
+        if (ftype->getReturnType()->isVoidTy()) {
+            builder.CreateRetVoid();
+        }else{
+            builder.CreateRet(call);
+        }
+    }
+
+    // `function` tetap ada untuk pemanggil yang tidak lewat NMethodCall
+    {
+        args.clear();
+        for (Function::arg_iterator it = function->arg_begin(); it != function->arg_end(); it++) {
+            args.push_back(&*it);
+        }
+
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", function);
+        Value *chosen = loadDispatchTarget(target, name + ".target", entry);
+        IRBuilder<> builder(entry);
+        CallInst *call = builder.CreateCall(chosen, args);
+        call->setTailCall();
+        if (ftype->getReturnType()->isVoidTy()) {
+            builder.CreateRetVoid();
+        }else{
+            builder.CreateRet(call);
+        }
+    }
+}
+
+/**
+ * Fungsi murni hanya boleh menerima dan mengembalikan int/double,
+ * supaya argumennya bisa dijadikan key memo.
+ */
+static bool checkPureSignature(CodeGenContext& context, NFunctionDeclaration& decl, FunctionType *ftype)
+{
+    bool ok = true;
+    Type *retTy = ftype->getReturnType();
+    if (!retTy->isIntegerTy() && !retTy->isDoubleTy()) {
+        context.error("pure function " + decl.id.name + " must return int or double");
+        ok = false;
+    }
+    for (unsigned i = 0; i < ftype->getNumParams(); i++) {
+        Type *argTy = ftype->getParamType(i);
+        if (!argTy->isIntegerTy() && !argTy->isDoubleTy()) {
+            context.error("pure function " + decl.id.name + " takes a non numeric argument " +
+                          decl.arguments[i]->id.name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+Value* NFunctionDeclaration::codeGen(CodeGenContext& context)
+{
+    vector<Type*> _argTypes;
+    VariableList::const_iterator it;
+    for (it = arguments.begin(); it != arguments.end(); it++) {
+        _argTypes.push_back(typeOf((**it).type));
+    }
+
+    ArrayRef<Type*> argTypes(_argTypes);
+
+    FunctionType *ftype = FunctionType::get(Type::getVoidTy(getGlobalContext()), argTypes, false);
+    if (this->type != nullptr) {
+        ftype = FunctionType::get(typeOf(*type), argTypes, false);
+    }
+
+    bool memoize = false;
+    if (isPure && checkPureSignature(context, *this, ftype)) {
+        // daftarkan sebelum body di-generate supaya rekursi diperbolehkan
+        context.pureFunctions.insert(id.name);
+        memoize = context.options.memoize;
+    }
+
+    // -flto=thin: fungsi bisa dipanggil (dan di-import) dari file lain,
+    // repl: dari entri berikutnya
+    GlobalValue::LinkageTypes linkage = context.options.thinLTO || context.options.repl
+                                            ? GlobalValue::ExternalLinkage
+                                            : GlobalValue::InternalLinkage;
+    Function *function = Function::Create(ftype, linkage, id.name.c_str(), context.module);
+
+    if (isHot && memoize) {
+        std::cerr << "warning: " << id.name << " is memoized, `panas` is ignored" << std::endl;
+    }else if (isHot && !supportsMultiversion(context)) {
+        std::cerr << "warning: `panas` needs an x86-64 target, " << id.name << " is built once" << std::endl;
+    }
+
+    if (memoize) {
+        // panggilan `id` (termasuk rekursi) lewat wrapper memo, body asli di `id.murni`
+        Function *impl = Function::Create(ftype, GlobalValue::InternalLinkage, id.name + ".murni", context.module);
+        generateFunctionBody(context, *this, impl);
+        generateMemoWrapper(context, function, impl);
+    }else if (isHot && supportsMultiversion(context)) {
+        generateMultiversion(context, *this, function);
+    }else{
+        generateFunctionBody(context, *this, function);
+        if (isPure) {
+            function->addFnAttr(Attribute::ReadNone);
+            function->addFnAttr(Attribute::NoUnwind);
+        }
+    }
+
     std::cout << "Creating function: " << id.name << std::endl;
     return function;
 }
+
+Value* NExternDeclaration::codeGen(CodeGenContext& context)
+{
+    vector<Type*> argTypes;
+    VariableList::const_iterator it;
+    for (it = arguments.begin(); it != arguments.end(); it++) {
+        argTypes.push_back(typeOf((**it).type));
+    }
+
+    Type *retTy = type != nullptr ? typeOf(*type) : Type::getVoidTy(getGlobalContext());
+    FunctionType *ftype = FunctionType::get(retTy, argTypes, false);
+
+    if (context.module->getFunction(id.name) != nullptr) {
+        context.error("function " + id.name + " is already declared");
+        return nullptr;
+    }
+
+    if (isPure) {
+        context.pureFunctions.insert(id.name);
+    }
+
+    Function *function = Function::Create(ftype, GlobalValue::ExternalLinkage, id.name.c_str(), context.module);
+    if (isPure) {
+        function->addFnAttr(Attribute::ReadNone);
+        function->addFnAttr(Attribute::NoUnwind);
+    }
+
+    std::cout << "Declaring extern function: " << id.name << std::endl;
+    return function;
+}
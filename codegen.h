@@ -1,4 +1,5 @@
 #include <stack>
+#include <set>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Type.h>
@@ -15,14 +16,25 @@
 #include <llvm/IR/IRBuilder.h>
 //#include <llvm/IR/ModuleProvider.h>
 #include <llvm/Support/TargetSelect.h>
-#include <llvm/ExecutionEngine/GenericValue.h>
-#include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/ProfileData/InstrProfReader.h>
+
+#include "debuginfo.h"
+#include "options.h"
+#include "profile.h"
 
 using namespace llvm;
 
 class NBlock;
 class NVariableDeclaration;
+class NFunctionDeclaration;
+
+/* Variabel berisi hasil `khusus(f, ...)`: dipanggil seperti f tanpa argumen yang diikat. */
+struct SpecializedHandle {
+    Function *generic;
+    unsigned bound;
+};
 
 class CodeGenBlock {
 public:
@@ -38,13 +50,34 @@ class CodeGenContext {
 
 public:
     Module *module;
-    CodeGenContext();
+    const CompileOptions& options;
+    TargetMachine *targetMachine;
+    std::set<std::string> pureFunctions;           // nama fungsi `murni` yang sudah dideklarasikan
+    std::map<std::string, GlobalVariable*> dispatchPointers; // fungsi `panas` -> pointer versi terpilih
+    NFunctionDeclaration *currentFunction = nullptr; // fungsi yang sedang di-generate
+    std::vector<FunctionProfile> profiles;         // --profile-generate/-use, fungsi bersarang
+    std::unique_ptr<IndexedInstrProfReader> profileReader; // --profile-use
+    unsigned profileMatched = 0, profileStale = 0;
+    std::unique_ptr<DebugInfo> debug;              // -g, -gline-tables-only, --remarks
+    // repl: variabel top level dari entri sebelumnya, sudah dideklarasikan di module ini
+    std::map<std::string, Value*> inheritedLocals;
+    std::map<std::string, NVariableDeclaration*> inheritedVarDecls;
+    // khusus(): nama variabel handle, dan IR sebelum optimasi untuk di-clone saat jalan
+    std::map<std::string, SpecializedHandle> specializedHandles;
+    std::unique_ptr<Module> specializeSource;
+    int errorCount = 0;
+
+    CodeGenContext(const CompileOptions& options, TargetMachine *targetMachine);
+
+    void error(const std::string& msg) { std::cerr << "error: " << msg << std::endl; errorCount++; }
 
     void generateCode(NBlock& root);
-    GenericValue runCode();
+    void keepSpecializeSource();
+    int runCode();
     std::map<std::string, Value*>& locals() { return blocks.top()->locals; }
     std::map<std::string, NVariableDeclaration*>& localVarDecs() { return blocks.top()->localVarDecls; }
     BasicBlock *currentBlock() { return blocks.top()->block; }
+    void setCurrentBlock(BasicBlock *block) { blocks.top()->block = block; }
     void pushBlock(BasicBlock *block) { blocks.push(new CodeGenBlock()); blocks.top()->block = block; }
     void popBlock() { CodeGenBlock *top = blocks.top(); blocks.pop(); delete top; }
     void copyLocals(std::map<std::string, Value*>& anotherLocals){ blocks.top()->locals = anotherLocals; }
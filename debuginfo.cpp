@@ -0,0 +1,159 @@
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/DebugLoc.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Support/Dwarf.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include "debuginfo.h"
+
+using namespace llvm;
+
+DebugInfo::DebugInfo(Module& module, const CompileOptions& opts) :
+    module(module), builder(module), optimized(opts.optLevel > 0), full(opts.debugLevel == DebugFull)
+{
+    std::string fileName = "<stdin>";
+    SmallString<256> directory;
+    sys::fs::current_path(directory);
+
+    if (!opts.sourcePath.empty()) {
+        SmallString<256> path(opts.sourcePath);
+        sys::fs::make_absolute(path);
+        fileName = sys::path::filename(path);
+        directory = sys::path::parent_path(path);
+    }
+
+    DIBuilder::DebugEmissionKind kind = opts.debugLevel == DebugFull ? DIBuilder::FullDebug
+                                                                     : DIBuilder::LineTablesOnly;
+    unit = builder.createCompileUnit(dwarf::DW_LANG_C, fileName, directory, "bosojowo",
+                                     optimized, "", 0, "", kind);
+    file = builder.createFile(fileName, directory);
+
+    // tanpa flag ini debug info dibuang ketika module dibaca lagi
+    module.addModuleFlag(Module::Warning, "Debug Info Version", DEBUG_METADATA_VERSION);
+    module.addModuleFlag(Module::Warning, "Dwarf Version",
+                         Triple(module.getTargetTriple()).isOSDarwin() ? 2 : 4);
+}
+
+/* Tipe DWARF untuk tipe jowo: int, double, str. */
+DIType *DebugInfo::typeOf(Type *type)
+{
+    if (type->isIntegerTy(64)) {
+        return builder.createBasicType("int", 64, 64, dwarf::DW_ATE_signed);
+    }else if (type->isDoubleTy()) {
+        return builder.createBasicType("double", 64, 64, dwarf::DW_ATE_float);
+    }else if (type->isPointerTy()) {
+        DIType *charTy = builder.createBasicType("char", 8, 8, dwarf::DW_ATE_signed_char);
+        return builder.createPointerType(charTy, 64, 64, "str");
+    }
+    return nullptr;
+}
+
+void DebugInfo::beginFunction(Function *function, unsigned line)
+{
+    // elemen pertama tipe return, nullptr untuk void
+    std::vector<Metadata*> signature;
+    if (full) {
+        signature.push_back(typeOf(function->getReturnType()));
+        for (Function::arg_iterator it = function->arg_begin(); it != function->arg_end(); it++) {
+            signature.push_back(typeOf(it->getType()));
+        }
+    }
+    DISubroutineType *type = builder.createSubroutineType(file, builder.getOrCreateTypeArray(signature));
+    DISubprogram *subprogram = builder.createFunction(unit, function->getName(), function->getName(),
+                                                      file, line, type, function->hasLocalLinkage(),
+                                                      true, line, 0, optimized, function);
+    scopes.push_back(subprogram);
+}
+
+void DebugInfo::endFunction()
+{
+    scopes.pop_back();
+}
+
+DILocalVariable *DebugInfo::createVariable(const std::string& name, unsigned line, Type *type, unsigned argNo)
+{
+    unsigned tag = argNo > 0 ? dwarf::DW_TAG_arg_variable : dwarf::DW_TAG_auto_variable;
+    // tetap ada walaupun variabelnya dioptimasi habis, debugger menampilkan <optimized out>
+    return builder.createLocalVariable(tag, scopes.back(), name, file, line, typeOf(type), true, 0, argNo);
+}
+
+void DebugInfo::declareVariable(AllocaInst *storage, const std::string& name, unsigned line, BasicBlock *block)
+{
+    if (!full || scopes.empty()) {
+        return;
+    }
+    DILocalVariable *variable = createVariable(name, line, storage->getAllocatedType(), 0);
+    builder.insertDeclare(storage, variable, builder.createExpression(),
+                          DebugLoc::get(line, 0, scopes.back()).get(), block);
+}
+
+void DebugInfo::declareValue(Value *value, const std::string& name, unsigned line, unsigned argNo,
+                             BasicBlock *block)
+{
+    if (!full || scopes.empty()) {
+        return;
+    }
+    DILocalVariable *variable = createVariable(name, line, value->getType(), argNo);
+    builder.insertDbgValueIntrinsic(value, 0, variable, builder.createExpression(),
+                                    DebugLoc::get(line, 0, scopes.back()).get(), block);
+}
+
+DebugInfo::Mark DebugInfo::mark(BasicBlock *current)
+{
+    Mark from = { current, &current->getParent()->back() };
+    return from;
+}
+
+/**
+ * Instruksi selalu ditambahkan di akhir block, jadi yang belum punya lokasi
+ * adalah ekornya. dbg.declare/dbg.value sudah punya lokasi sendiri dan dilewati.
+ */
+static void setTailLocations(BasicBlock& bb, const DebugLoc& loc)
+{
+    for (BasicBlock::reverse_iterator it = bb.rbegin(); it != bb.rend(); it++) {
+        if (isa<DbgInfoIntrinsic>(*it)) {
+            continue;
+        }
+        if (it->getDebugLoc()) {
+            break;
+        }
+        it->setDebugLoc(loc);
+    }
+}
+
+void DebugInfo::setLocations(const Mark& from, unsigned line)
+{
+    if (scopes.empty()) {
+        return;
+    }
+    DebugLoc loc = DebugLoc::get(line, 0, scopes.back());
+    Function *function = from.block->getParent();
+
+    setTailLocations(*from.block, loc);
+    Function::iterator it(from.last);
+    for (it++; it != function->end(); it++) {
+        setTailLocations(*it, loc);
+    }
+}
+
+void DebugInfo::setLocations(Function *function, unsigned line)
+{
+    if (scopes.empty()) {
+        return;
+    }
+    DebugLoc loc = DebugLoc::get(line, 0, scopes.back());
+    for (BasicBlock& bb : *function) {
+        for (Instruction& inst : bb) {
+            if (!inst.getDebugLoc()) {
+                inst.setDebugLoc(loc);
+            }
+        }
+    }
+}
+
+void DebugInfo::finalize()
+{
+    builder.finalize();
+}
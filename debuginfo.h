@@ -0,0 +1,74 @@
+#ifndef BOSOJOWO_DEBUGINFO_H
+#define BOSOJOWO_DEBUGINFO_H
+
+#include <string>
+#include <vector>
+
+#include <llvm/IR/DIBuilder.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "options.h"
+
+/**
+ * Debug info DWARF untuk kode hasil kompile .jowo.
+ *
+ * Satu compile unit per file sumber, satu subprogram per fungsi. Lokasi
+ * diberikan per statement: setelah statement di-generate, instruksi baru yang
+ * belum punya lokasi diberi baris statement tersebut, sehingga statement
+ * bersarang (arm `nek`, body `muter`) mendapat barisnya sendiri. Instruksi
+ * baru hanya dicari di ekor current block saat statement dimulai dan di block
+ * yang dibuat sesudahnya, jadi biayanya sebanding dengan kode statement itu.
+ *
+ * Dengan -g (DebugFull) subprogram juga punya tipe argumen/return, dan
+ * argumen, variabel lokal dan variabel loop `i` dideklarasikan sehingga
+ * debugger dan profiler bisa menampilkan nilainya. Variabel di alloca memakai
+ * dbg.declare supaya mem2reg/SROA meneruskannya sebagai dbg.value ketika
+ * dioptimasi.
+ */
+class DebugInfo {
+    llvm::Module& module;
+    llvm::DIBuilder builder;
+    llvm::DIFile *file;
+    llvm::DICompileUnit *unit;
+    std::vector<llvm::DISubprogram*> scopes;    // fungsi yang sedang di-generate
+    bool optimized;
+    bool full;
+
+    llvm::DIType *typeOf(llvm::Type *type);
+    llvm::DILocalVariable *createVariable(const std::string& name, unsigned line, llvm::Type *type,
+                                          unsigned argNo);
+
+public:
+    DebugInfo(llvm::Module& module, const CompileOptions& opts);
+
+    void beginFunction(llvm::Function *function, unsigned line);
+    void endFunction();
+
+    /* Variabel lokal di alloca (`int x = ...`). */
+    void declareVariable(llvm::AllocaInst *storage, const std::string& name, unsigned line,
+                         llvm::BasicBlock *block);
+
+    /* Nilai SSA: argumen fungsi (argNo mulai 1) atau variabel loop (argNo 0). */
+    void declareValue(llvm::Value *value, const std::string& name, unsigned line, unsigned argNo,
+                      llvm::BasicBlock *block);
+
+    /* Posisi codegen sebelum sebuah statement di-generate. */
+    struct Mark {
+        llvm::BasicBlock *block;    // current block
+        llvm::BasicBlock *last;     // block terakhir di fungsi
+    };
+    Mark mark(llvm::BasicBlock *current);
+
+    /* Beri lokasi `line` ke instruksi yang dibuat sejak `from` dan belum punya lokasi. */
+    void setLocations(const Mark& from, unsigned line);
+
+    /* Sama, tapi memeriksa seluruh `function`; untuk sekali di akhir fungsi. */
+    void setLocations(llvm::Function *function, unsigned line);
+
+    void finalize();
+};
+
+#endif
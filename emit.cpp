@@ -0,0 +1,241 @@
+#include <iostream>
+#include <fstream>
+#include <thread>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Bitcode/ReaderWriter.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include "emit.h"
+
+using namespace llvm;
+
+bool writeTextIR(Module& module, const std::string& path)
+{
+    std::ofstream outFile(path, std::ios::binary);
+    if (!outFile) {
+        std::cerr << "error: cannot open " << path << std::endl;
+        return false;
+    }
+    raw_os_ostream outFileOsStream(outFile);
+    module.print(outFileOsStream, nullptr);
+    return true;
+}
+
+bool writeBitcode(Module& module, const std::string& path)
+{
+    std::error_code ec;
+    raw_fd_ostream out(path, ec, sys::fs::F_None);
+    if (ec) {
+        std::cerr << "error: cannot open " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+    WriteBitcodeToFile(&module, out);
+    return true;
+}
+
+bool linkModuleFile(Module& dest, const std::string& path, std::string& mainOrigin)
+{
+    SMDiagnostic diag;
+    std::unique_ptr<Module> src = parseIRFile(path, diag, dest.getContext());
+    if (!src) {
+        diag.print("bosojowo", errs());
+        return false;
+    }
+
+    // kode top level setiap file jadi `main`, hanya satu input yang boleh punya
+    Function *main = src->getFunction("main");
+    if (main != nullptr && !main->isDeclaration()) {
+        if (!mainOrigin.empty()) {
+            std::cerr << "error: both " << mainOrigin << " and " << path << " define main (top-level code); "
+                      << "compile files that only hold functions with -flto=thin so they have no main" << std::endl;
+            return false;
+        }
+        mainOrigin = path;
+    }
+
+    std::cout << "Linking module " << path << std::endl;
+    src->setTargetTriple(dest.getTargetTriple());
+    src->setDataLayout(dest.getDataLayout());
+
+    if (Linker::LinkModules(&dest, src.get())) {
+        std::cerr << "error: cannot link " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool writeNativeFile(Module& module, TargetMachine& tm, const std::string& path,
+                     TargetMachine::CodeGenFileType type)
+{
+    std::error_code ec;
+    sys::fs::OpenFlags flags = type == TargetMachine::CGFT_AssemblyFile ? sys::fs::F_Text : sys::fs::F_None;
+    raw_fd_ostream out(path, ec, flags);
+    if (ec) {
+        std::cerr << "error: cannot open " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    legacy::PassManager pm;
+    pm.add(new TargetLibraryInfoWrapperPass(Triple(module.getTargetTriple())));
+
+    if (tm.addPassesToEmitFile(pm, out, type)) {
+        std::cerr << "error: target " << module.getTargetTriple() << " cannot emit this file type" << std::endl;
+        return false;
+    }
+
+    pm.run(module);
+    return true;
+}
+
+/**
+ * Global lokal jadi external (hidden) supaya bisa dirujuk dari partisi lain.
+ * Hidden: tetap tidak terlihat dari luar executable.
+ */
+static void externalizeLocals(Module& module)
+{
+    std::vector<GlobalValue*> values;
+    for (Function& function : module) {
+        values.push_back(&function);
+    }
+    for (GlobalVariable& global : module.globals()) {
+        values.push_back(&global);
+    }
+    for (GlobalAlias& alias : module.aliases()) {
+        values.push_back(&alias);
+    }
+    for (GlobalValue *value : values) {
+        if (value->hasLocalLinkage()) {
+            value->setLinkage(GlobalValue::ExternalLinkage);
+            value->setVisibility(GlobalValue::HiddenVisibility);
+        }
+        if (!value->hasName()) {
+            value->setName("bosojowo.part");
+        }
+    }
+}
+
+/* Partisi dari MD5 nama, sama setiap run dan tidak tergantung urutan di module. */
+static unsigned partitionOf(const GlobalValue& value, unsigned count)
+{
+    const GlobalValue *owner = &value;
+    // alias ikut objek yang di-alias, definisinya harus di partisi yang sama
+    if (const GlobalAlias *alias = dyn_cast<GlobalAlias>(&value)) {
+        if (const GlobalObject *object = alias->getBaseObject()) {
+            owner = object;
+        }
+    }
+    MD5 hash;
+    hash.update(owner->getName());
+    MD5::MD5Result result;
+    hash.final(result);
+    uint32_t bits = result[0] | (result[1] << 8) | (result[2] << 16) | ((uint32_t)result[3] << 24);
+    return bits % count;
+}
+
+/* Definisi yang bukan milik partisi ini jadi deklarasi. */
+static void keepPartition(Module& module, unsigned self, unsigned count)
+{
+    for (Function& function : module) {
+        if (!function.isDeclaration() && partitionOf(function, count) != self) {
+            function.deleteBody();
+            function.setLinkage(GlobalValue::ExternalLinkage);
+            function.setComdat(nullptr);
+        }
+    }
+    for (GlobalVariable& global : module.globals()) {
+        if (!global.isDeclaration() && partitionOf(global, count) != self) {
+            global.setInitializer(nullptr);
+            global.setLinkage(GlobalValue::ExternalLinkage);
+            global.setComdat(nullptr);
+        }
+    }
+
+    // alias tidak punya bentuk deklarasi, diganti deklarasi biasa dengan nama yang sama
+    std::vector<GlobalAlias*> aliases;
+    for (GlobalAlias& alias : module.aliases()) {
+        if (partitionOf(alias, count) != self) {
+            aliases.push_back(&alias);
+        }
+    }
+    for (GlobalAlias *alias : aliases) {
+        Type *type = alias->getType()->getElementType();
+        GlobalValue *decl;
+        if (FunctionType *ftype = dyn_cast<FunctionType>(type)) {
+            decl = Function::Create(ftype, GlobalValue::ExternalLinkage, "", &module);
+        }else{
+            decl = new GlobalVariable(module, type, false, GlobalValue::ExternalLinkage, nullptr);
+        }
+        decl->setVisibility(alias->getVisibility());
+        decl->takeName(alias);
+        alias->replaceAllUsesWith(ConstantExpr::getBitCast(decl, alias->getType()));
+        alias->eraseFromParent();
+    }
+}
+
+bool writeNativeFilesParallel(Module& module, TargetMachine& tm, const std::vector<std::string>& paths)
+{
+    unsigned count = paths.size();
+    externalizeLocals(module);
+
+    // setiap partisi lewat bitcode supaya bisa dibaca ke LLVMContext milik threadnya
+    std::vector<std::string> partitions(count);
+    for (unsigned i = 0; i < count; i++) {
+        std::unique_ptr<Module> partition(CloneModule(&module));
+        keepPartition(*partition, i, count);
+        raw_string_ostream out(partitions[i]);
+        WriteBitcodeToFile(partition.get(), out);
+        out.flush();
+    }
+
+    // TargetMachine tidak thread safe, satu per partisi
+    std::vector<std::unique_ptr<TargetMachine> > machines;
+    for (unsigned i = 0; i < count; i++) {
+        TargetMachine *machine = tm.getTarget().createTargetMachine(
+            tm.getTargetTriple().str(), tm.getTargetCPU(), tm.getTargetFeatureString(), tm.Options,
+            tm.getRelocationModel(), tm.getCodeModel(), tm.getOptLevel());
+        if (machine == nullptr) {
+            std::cerr << "error: could not create target machine for " << tm.getTargetTriple().str() << std::endl;
+            return false;
+        }
+        machines.push_back(std::unique_ptr<TargetMachine>(machine));
+    }
+
+    std::cout << "Generating code on " << count << " threads" << std::endl;
+
+    std::vector<char> written(count, 0);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < count; i++) {
+        workers.push_back(std::thread([&, i]() {
+            LLVMContext ctx;
+            ErrorOr<std::unique_ptr<Module> > partition =
+                parseBitcodeFile(MemoryBufferRef(partitions[i], paths[i]), ctx);
+            written[i] = partition &&
+                writeNativeFile(**partition, *machines[i], paths[i], TargetMachine::CGFT_ObjectFile);
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        if (!written[i]) {
+            std::cerr << "error: cannot generate partition " << i << " (" << paths[i] << ")" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef BOSOJOWO_EMIT_H
+#define BOSOJOWO_EMIT_H
+
+#include <string>
+#include <vector>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+/* Tulis module sebagai LLVM IR teks (.ll). */
+bool writeTextIR(llvm::Module& module, const std::string& path);
+
+/* Tulis module sebagai LLVM bitcode (.bc), lebih kecil dan cepat dibaca dari teks. */
+bool writeBitcode(llvm::Module& module, const std::string& path);
+
+/**
+ * Baca module .bc (atau .ll) hasil run sebelumnya lalu gabungkan ke `dest`.
+ * Triple dan DataLayout mengikuti `dest`. `mainOrigin` adalah input yang
+ * mendefinisikan `main` di `dest` (kosong apabila belum ada): input kedua
+ * dengan `main` ditolak dengan pesan yang menyebut keduanya.
+ */
+bool linkModuleFile(llvm::Module& dest, const std::string& path, std::string& mainOrigin);
+
+/**
+ * Generate kode native langsung dari module di memori lewat TargetMachine,
+ * tanpa llc. `type` memilih object file (.o) atau assembly (.s).
+ */
+bool writeNativeFile(llvm::Module& module, llvm::TargetMachine& tm, const std::string& path,
+                     llvm::TargetMachine::CodeGenFileType type);
+
+/**
+ * Seperti writeNativeFile tapi module dipecah menjadi `paths.size()` bagian dan
+ * setiap bagian di-generate di thread, LLVMContext dan TargetMachine sendiri.
+ * Pembagian fungsi dan global ditentukan dari hash nama, jadi isi setiap file
+ * tidak tergantung urutan thread. Global lokal di `module` dijadikan external
+ * hidden supaya bisa dirujuk antar partisi.
+ */
+bool writeNativeFilesParallel(llvm::Module& module, llvm::TargetMachine& tm,
+                              const std::vector<std::string>& paths);
+
+#endif
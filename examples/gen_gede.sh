@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+#
+# Buat program jowo besar untuk mengukur kompilasi, mis. IR teks vs bitcode:
+#
+#   ./examples/gen_gede.sh 5000 > /tmp/gede.jowo
+#   ./bin/bosojowo --time /tmp/gede.jowo -o /tmp/gede.ll
+#   ./bin/bosojowo --time /tmp/gede.jowo -o /tmp/gede.bc
+#   ./bin/bosojowo --time /tmp/gede.bc -O2 -o /tmp/gede.o
+#   ls -l /tmp/gede.ll /tmp/gede.bc
+
+N=${1:-1000}
+
+for ((i = 0; i < N; i++)); do
+    echo "fungsi f$i(double x, double y):double"
+    echo "mulai"
+    echo "    double a = x * $i.5 + y"
+    echo "    double b = (nek a < y njuk a - y nek ora y - a)"
+    echo "    nyoh a * b + $i.0"
+    echo "bar"
+    echo ""
+done
+
+echo "double s = 0.0"
+for ((i = 0; i < N; i++)); do
+    echo "s = s + f$i(s, $i.0)"
+done
+echo "printf(\"%f\\n\", s)"
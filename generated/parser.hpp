@@ -0,0 +1,127 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_GENERATED_PARSER_HPP_INCLUDED
+# define YY_YY_GENERATED_PARSER_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 1
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    TIDENTIFIER = 258,             /* TIDENTIFIER  */
+    TINTEGER = 259,                /* TINTEGER  */
+    TDOUBLE = 260,                 /* TDOUBLE  */
+    TSTR = 261,                    /* TSTR  */
+    TCEQ = 262,                    /* TCEQ  */
+    TCNE = 263,                    /* TCNE  */
+    TCLT = 264,                    /* TCLT  */
+    TCLE = 265,                    /* TCLE  */
+    TCGT = 266,                    /* TCGT  */
+    TCGE = 267,                    /* TCGE  */
+    TEQUAL = 268,                  /* TEQUAL  */
+    TLPAREN = 269,                 /* TLPAREN  */
+    TRPAREN = 270,                 /* TRPAREN  */
+    TLBRACE = 271,                 /* TLBRACE  */
+    TRBRACE = 272,                 /* TRBRACE  */
+    TCOMMA = 273,                  /* TCOMMA  */
+    TDOT = 274,                    /* TDOT  */
+    TDDOT = 275,                   /* TDDOT  */
+    TRETN = 276,                   /* TRETN  */
+    TFUNC = 277,                   /* TFUNC  */
+    TBLOCKBEGIN = 278,             /* TBLOCKBEGIN  */
+    TBLOCKEND = 279,               /* TBLOCKEND  */
+    TIF = 280,                     /* TIF  */
+    TTHEN = 281,                   /* TTHEN  */
+    TELSE = 282,                   /* TELSE  */
+    TPLUS = 283,                   /* TPLUS  */
+    TMINUS = 284,                  /* TMINUS  */
+    TMUL = 285,                    /* TMUL  */
+    TDIV = 286,                    /* TDIV  */
+    TLOOP = 287,                   /* TLOOP  */
+    TUNTIL = 288,                  /* TUNTIL  */
+    TPURE = 289,                   /* TPURE  */
+    THOT = 290,                    /* THOT  */
+    TEXTERN = 291                  /* TEXTERN  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 12 "parser.y"
+
+    Node *node;
+    NBlock *block;
+    NExpression *expr;
+    NStatement *stmt;
+    NIdentifier *ident;
+    NVariableDeclaration *var_decl;
+    std::vector<NVariableDeclaration*> *varvec;
+    std::vector<NExpression*> *exprvec;
+    std::string *string;
+    int token;
+
+#line 113 "generated/parser.hpp"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_GENERATED_PARSER_HPP_INCLUDED  */
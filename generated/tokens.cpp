@@ -861,6 +861,11 @@ SAVE_TOKEN; return TSTR;
 case 16:
 YY_RULE_SETUP
 #line 30 "tokens.l"
+/* salinan tanpa flex: tabel di atas belum punya kata kunci murni, panas dan
+   njaba dari tokens.l, dikenali dari identifier dengan hasil yang sama */
+if (strcmp(yytext, "murni") == 0) return TOKEN(TPURE);
+if (strcmp(yytext, "panas") == 0) return TOKEN(THOT);
+if (strcmp(yytext, "njaba") == 0) return TOKEN(TEXTERN);
 SAVE_TOKEN; return TIDENTIFIER;
 	YY_BREAK
 case 17:
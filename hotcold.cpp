@@ -0,0 +1,135 @@
+#include <iostream>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/Transforms/Utils/CodeExtractor.h>
+
+#include "hotcold.h"
+
+using namespace llvm;
+
+// region yang lebih kecil dari ini tidak sebanding dengan biaya call
+static const unsigned kMinColdInstructions = 8;
+
+/* Block tujuan cabang dengan weight 0 sementara arah lainnya pernah diambil. */
+static BasicBlock *coldSuccessor(BasicBlock& bb)
+{
+    BranchInst *branch = dyn_cast<BranchInst>(bb.getTerminator());
+    if (branch == nullptr || !branch->isConditional()) {
+        return nullptr;
+    }
+    MDNode *prof = branch->getMetadata(LLVMContext::MD_prof);
+    if (prof == nullptr || prof->getNumOperands() != 3) {
+        return nullptr;
+    }
+
+    uint64_t weights[2];
+    for (unsigned i = 0; i < 2; i++) {
+        ConstantInt *weight = mdconst::dyn_extract<ConstantInt>(prof->getOperand(i + 1));
+        if (weight == nullptr) {
+            return nullptr;
+        }
+        weights[i] = weight->getZExtValue();
+    }
+
+    for (unsigned i = 0; i < 2; i++) {
+        BasicBlock *target = branch->getSuccessor(i);
+        if (weights[i] == 0 && weights[1 - i] > 0 && target->getSinglePredecessor() == &bb) {
+            return target;
+        }
+    }
+    return nullptr;
+}
+
+/* Region dingin: semua block yang didominasi `entry`, tanpa `ret` di dalamnya. */
+static bool coldRegion(DominatorTree& dt, BasicBlock *entry, SmallVectorImpl<BasicBlock*>& region)
+{
+    dt.getDescendants(entry, region);
+
+    unsigned instructions = 0;
+    for (BasicBlock *bb : region) {
+        if (isa<ReturnInst>(bb->getTerminator())) {
+            return false;
+        }
+        instructions += bb->size();
+    }
+    return instructions >= kMinColdInstructions;
+}
+
+static unsigned splitFunction(Function& function)
+{
+    std::vector<BasicBlock*> candidates;
+    for (BasicBlock& bb : function) {
+        if (BasicBlock *cold = coldSuccessor(bb)) {
+            candidates.push_back(cold);
+        }
+    }
+
+    unsigned split = 0;
+    for (BasicBlock *cold : candidates) {
+        // sudah ikut terpindah bersama region sebelumnya
+        if (cold->getParent() != &function) {
+            continue;
+        }
+
+        DominatorTree dt;
+        dt.recalculate(function);
+
+        SmallVector<BasicBlock*, 16> region;
+        if (!coldRegion(dt, cold, region)) {
+            continue;
+        }
+
+        CodeExtractor extractor(region, &dt);
+        if (!extractor.isEligible()) {
+            continue;
+        }
+        Function *outlined = extractor.extractCodeRegion();
+        if (outlined == nullptr) {
+            continue;
+        }
+        outlined->addFnAttr(Attribute::Cold);
+        outlined->addFnAttr(Attribute::NoInline);
+        split++;
+    }
+    return split;
+}
+
+void splitColdCode(Module& module, const CompileOptions& opts)
+{
+    std::vector<Function*> functions;
+    for (Function& function : module) {
+        if (!function.isDeclaration()) {
+            functions.push_back(&function);
+        }
+    }
+
+    unsigned split = 0;
+    for (Function *function : functions) {
+        split += splitFunction(*function);
+    }
+
+    unsigned hot = 0, cold = 0;
+    if (Triple(module.getTargetTriple()).isOSBinFormatELF()) {
+        for (Function& function : module) {
+            if (function.isDeclaration() || function.hasSection()) {
+                continue;
+            }
+            if (function.hasFnAttribute(Attribute::Cold)) {
+                function.setSection(".text.unlikely");
+                cold++;
+            }else if (function.hasFnAttribute(Attribute::InlineHint) && function.getEntryCount().hasValue()) {
+                // inlinehint dari profile: fungsi panas (lihat finishModuleProfile)
+                function.setSection(".text.hot");
+                hot++;
+            }
+        }
+    }
+
+    std::cout << "Split " << split << " cold regions, " << hot << " hot / "
+              << cold << " cold functions placed" << std::endl;
+}
@@ -0,0 +1,19 @@
+#ifndef BOSOJOWO_HOTCOLD_H
+#define BOSOJOWO_HOTCOLD_H
+
+#include <llvm/IR/Module.h>
+
+#include "options.h"
+
+/**
+ * -fsplit-cold: pisahkan kode yang menurut profile tidak pernah dijalankan.
+ *
+ * Cabang dengan branch weight 0 (dari --profile-use) yang menuju region
+ * single-entry dipindah ke fungsi baru bertanda cold/noinline, sehingga body
+ * fungsi asal yang panas lebih padat di i-cache. Di target ELF fungsi cold
+ * ditaruh di .text.unlikely dan fungsi panas di .text.hot supaya linker
+ * mengelompokkannya.
+ */
+void splitColdCode(llvm::Module& module, const CompileOptions& opts);
+
+#endif
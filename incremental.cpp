@@ -0,0 +1,374 @@
+#include <iostream>
+#include <map>
+#include <set>
+#include <typeinfo>
+#include <stdio.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "node.h"
+#include "codegen.h"
+#include "cache.h"
+#include "emit.h"
+#include "incremental.h"
+#include "linker.h"
+#include "optimize.h"
+#include "sizereport.h"
+
+using namespace llvm;
+
+// nama fragmen kode top level
+static const char *kTopLevel = "main";
+
+// file sementara penulis yang crash dibersihkan setelah ini
+static const time_t kStaleTemporarySeconds = 3600;
+
+/* AST satu fungsi sebagai teks, plus semua nama yang dirujuknya. */
+struct Fingerprint {
+    std::string text;
+    std::set<std::string> uses;
+    bool lines;     // dengan debug info nomor baris ikut masuk object
+};
+
+static void fingerprint(const Node *node, Fingerprint& fp);
+
+static void fingerprintArguments(const VariableList& arguments, Fingerprint& fp)
+{
+    fp.text += std::to_string(arguments.size()) + " ";
+    for (const NVariableDeclaration *arg : arguments) {
+        fingerprint(arg, fp);
+    }
+}
+
+static void fingerprint(const Node *node, Fingerprint& fp)
+{
+    if (node == nullptr) {
+        fp.text += "- ";
+        return;
+    }
+    fp.text += typeid(*node).name();
+    fp.text += " ";
+    if (fp.lines) {
+        fp.text += std::to_string(node->line) + " ";
+    }
+
+    if (const NInteger *n = dynamic_cast<const NInteger*>(node)) {
+        fp.text += std::to_string(n->value);
+    }else if (const NDouble *n = dynamic_cast<const NDouble*>(node)) {
+        char bits[32];
+        snprintf(bits, sizeof(bits), "%a", n->value);
+        fp.text += bits;
+    }else if (const NIdentifier *n = dynamic_cast<const NIdentifier*>(node)) {
+        // termasuk nama variabel; nama yang bukan fungsi diabaikan saat mencari callee
+        fp.text += n->name;
+        fp.uses.insert(n->name);
+    }else if (const NStr *n = dynamic_cast<const NStr*>(node)) {
+        fp.text += std::to_string(n->text.size()) + ":" + n->text;
+    }else if (const NMethodCall *n = dynamic_cast<const NMethodCall*>(node)) {
+        fingerprint(&n->id, fp);
+        fp.text += std::to_string(n->arguments.size()) + " ";
+        for (const NExpression *arg : n->arguments) {
+            fingerprint(arg, fp);
+        }
+    }else if (const NBinaryOperator *n = dynamic_cast<const NBinaryOperator*>(node)) {
+        fp.text += std::to_string(n->op) + " ";
+        fingerprint(&n->lhs, fp);
+        fingerprint(&n->rhs, fp);
+    }else if (const NAssignment *n = dynamic_cast<const NAssignment*>(node)) {
+        fingerprint(&n->lhs, fp);
+        fingerprint(&n->rhs, fp);
+    }else if (const NBlock *n = dynamic_cast<const NBlock*>(node)) {
+        fp.text += std::to_string(n->statements.size()) + " ";
+        for (const NStatement *stmt : n->statements) {
+            fingerprint(stmt, fp);
+        }
+    }else if (const NConditionalBlock *n = dynamic_cast<const NConditionalBlock*>(node)) {
+        fingerprint(&n->cond, fp);
+        fingerprint(n->thenStmt, fp);
+        fingerprint(n->elseStmt, fp);
+    }else if (const NLoop *n = dynamic_cast<const NLoop*>(node)) {
+        fingerprint(&n->exprFrom, fp);
+        fingerprint(&n->exprUntil, fp);
+        fingerprint(n->block, fp);
+    }else if (const NExpressionStatement *n = dynamic_cast<const NExpressionStatement*>(node)) {
+        fingerprint(&n->expression, fp);
+    }else if (const NReturn *n = dynamic_cast<const NReturn*>(node)) {
+        fingerprint(n->lhs, fp);
+    }else if (const NVariableDeclaration *n = dynamic_cast<const NVariableDeclaration*>(node)) {
+        fingerprint(&n->type, fp);
+        fingerprint(&n->id, fp);
+        fingerprint(n->assignmentExpr, fp);
+    }else if (const NFunctionDeclaration *n = dynamic_cast<const NFunctionDeclaration*>(node)) {
+        fp.text += std::string(n->isPure ? "murni " : "") + (n->isHot ? "panas " : "");
+        fingerprint(n->type, fp);
+        fingerprint(&n->id, fp);
+        fingerprintArguments(n->arguments, fp);
+        fingerprint(&n->block, fp);
+    }else if (const NExternDeclaration *n = dynamic_cast<const NExternDeclaration*>(node)) {
+        fp.text += n->isPure ? "murni " : "";
+        fingerprint(n->type, fp);
+        fingerprint(&n->id, fp);
+        fingerprintArguments(n->arguments, fp);
+    }
+    fp.text += ";";
+}
+
+/* Satu fungsi, extern atau kode top level di dependency graph; extern tidak punya fragmen. */
+struct Unit {
+    std::string fingerprint;        // hash AST
+    std::set<std::string> uses;
+};
+
+typedef std::map<std::string, Unit> UnitMap;
+
+static void addUnit(UnitMap& units, const std::string& name, Fingerprint& fp)
+{
+    Unit& unit = units[name];
+    unit.fingerprint = hashHex(fp.text);
+    unit.uses.swap(fp.uses);
+}
+
+/* `name` beserta semua fungsi dan extern yang dipanggilnya secara transitif. */
+static void collectClosure(const UnitMap& units, const std::string& name, std::set<std::string>& closure)
+{
+    UnitMap::const_iterator unit = units.find(name);
+    if (unit == units.end() || !closure.insert(name).second) {
+        return;
+    }
+    for (const std::string& use : unit->second.uses) {
+        collectClosure(units, use, closure);
+    }
+}
+
+/**
+ * Bangun dependency graph dari AST. `order` berisi fragmen sesuai urutan di
+ * source, `main` duluan apabila ada kode top level.
+ */
+static bool buildUnits(NBlock& root, const CompileOptions& opts, UnitMap& units, std::vector<std::string>& order)
+{
+    Fingerprint topLevel;
+    topLevel.lines = opts.debugLevel != DebugNone;
+    bool hasTopLevel = false;
+
+    for (NStatement *stmt : root.statements) {
+        NFunctionDeclaration *function = dynamic_cast<NFunctionDeclaration*>(stmt);
+        NExternDeclaration *external = dynamic_cast<NExternDeclaration*>(stmt);
+        if (function == nullptr && external == nullptr) {
+            fingerprint(stmt, topLevel);
+            hasTopLevel = true;
+            continue;
+        }
+
+        const std::string& name = function != nullptr ? function->id.name : external->id.name;
+        if (units.count(name) > 0 || name == kTopLevel) {
+            std::cerr << "error: function " << name << " is already declared" << std::endl;
+            return false;
+        }
+        Fingerprint fp;
+        fp.lines = topLevel.lines;
+        fingerprint(stmt, fp);
+        addUnit(units, name, fp);
+        if (function != nullptr) {
+            order.push_back(name);
+        }
+    }
+
+    if (hasTopLevel) {
+        addUnit(units, kTopLevel, topLevel);
+        order.insert(order.begin(), kTopLevel);
+    }
+    return true;
+}
+
+/**
+ * Key fragmen: nama fragmen, compilerFingerprint dan hash AST setiap fungsi di
+ * closure-nya. Callee ikut karena body-nya bisa di-inline ke fragmen ini.
+ */
+static std::string fragmentKey(const UnitMap& units, const std::string& name, const std::string& buildKey)
+{
+    std::set<std::string> closure;
+    collectClosure(units, name, closure);
+
+    std::string key = buildKey + "fragment " + name + "\n";
+    for (const std::string& member : closure) {
+        key += member + " " + units.find(member)->second.fingerprint + "\n";
+    }
+    return hashHex(key);
+}
+
+/**
+ * Codegen, optimasi dan generate object untuk satu fragmen. Module hanya berisi
+ * fungsi di closure `name` (dan kode top level untuk `main`); selain `name`
+ * semua fungsi jowo jadi available_externally.
+ */
+static bool compileFragment(NBlock& root, const UnitMap& units, const std::string& name,
+                            TargetMachine& tm, const CompileOptions& opts, const std::string& path)
+{
+    std::set<std::string> closure;
+    collectClosure(units, name, closure);
+
+    // statement dipinjam dari `root`, NBlock tidak menghapusnya
+    NBlock partial;
+    for (NStatement *stmt : root.statements) {
+        NFunctionDeclaration *function = dynamic_cast<NFunctionDeclaration*>(stmt);
+        NExternDeclaration *external = dynamic_cast<NExternDeclaration*>(stmt);
+        if (function != nullptr || external != nullptr) {
+            const std::string& declared = function != nullptr ? function->id.name : external->id.name;
+            if (closure.count(declared) > 0) {
+                partial.statements.push_back(stmt);
+            }
+        }else if (name == kTopLevel) {
+            partial.statements.push_back(stmt);
+        }
+    }
+
+    // seperti -flto=thin: fungsi diekspor, `weruhi` linkonce_odr, tanpa kode
+    // top level `main` tidak dibuat
+    CompileOptions fragmentOpts = opts;
+    fragmentOpts.thinLTO = true;
+    fragmentOpts.wholeProgram = false;
+    fragmentOpts.jobs = 1;
+
+    std::unique_ptr<Module> module;
+    CodeGenContext context(fragmentOpts, &tm);
+    context.generateCode(partial);
+    module.reset(context.module);
+    context.module = nullptr;
+    if (context.errorCount > 0) {
+        std::cerr << context.errorCount << " error(s)" << std::endl;
+        return false;
+    }
+
+    for (Function& function : *module) {
+        std::string declared = function.getName().str();
+        if (!function.isDeclaration() && declared != name && units.count(declared) > 0) {
+            function.setLinkage(GlobalValue::AvailableExternallyLinkage);
+        }
+    }
+    fragmentOpts.thinLTO = false;
+    if (!optimizeModule(*module, tm, fragmentOpts, true)) {
+        return false;
+    }
+
+    // pembaca tidak pernah melihat object yang setengah ditulis, nama sementara
+    // unik per penulis supaya build paralel di direktori yang sama tidak bentrok
+    SmallString<128> tmpPath;
+    if (sys::fs::createUniqueFile(path + "-%%%%%%.tmp", tmpPath)) {
+        std::cerr << "error: cannot create a temporary file next to " << path << std::endl;
+        return false;
+    }
+    if (!writeNativeFile(*module, tm, tmpPath.str().str(), TargetMachine::CGFT_ObjectFile)) {
+        sys::fs::remove(tmpPath);
+        return false;
+    }
+    if (sys::fs::rename(tmpPath, path)) {
+        std::cerr << "error: cannot write " << path << std::endl;
+        sys::fs::remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+/* Nama file fragmen: key (MD5 hex) + `.o`, sisanya `suffix` apabila ada. */
+static bool isFragmentName(const std::string& file, const std::string& suffix)
+{
+    static const size_t kKeyLength = 32;
+    if (file.size() < kKeyLength + 2 + suffix.size() ||
+        file.compare(kKeyLength, 2, ".o") != 0 ||
+        file.find_first_not_of("0123456789abcdef") < kKeyLength) {
+        return false;
+    }
+    return suffix.empty() ? file.size() == kKeyLength + 2
+                          : file.compare(file.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * Hapus object fragmen dari build sebelumnya yang tidak dipakai lagi. Hanya
+ * nama yang ditulis --incremental yang disentuh, DIR boleh berisi file lain;
+ * file sementara build lain yang masih jalan dibiarkan sampai basi.
+ */
+static void removeStaleFragments(const std::string& dir, const std::set<std::string>& current)
+{
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return;
+    }
+    time_t now = time(nullptr);
+    while (struct dirent *ent = readdir(d)) {
+        std::string file = ent->d_name;
+        std::string path = dir + "/" + file;
+        if (isFragmentName(file, "")) {
+            if (current.count(file) == 0) {
+                unlink(path.c_str());
+            }
+        }else if (isFragmentName(file, ".tmp")) {
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0 && now - st.st_mtime > kStaleTemporarySeconds) {
+                unlink(path.c_str());
+            }
+        }
+    }
+    closedir(d);
+}
+
+bool incrementalBuild(NBlock& root, int argc, char **argv, TargetMachine& tm, const CompileOptions& opts)
+{
+    UnitMap units;
+    std::vector<std::string> order;
+    if (!buildUnits(root, opts, units, order)) {
+        return false;
+    }
+    if (order.empty()) {
+        std::cerr << "error: " << opts.sourcePath << " has no functions or top level code" << std::endl;
+        return false;
+    }
+
+    std::string buildKey = compilerFingerprint(argc, argv, opts, tm);
+    if (!opts.profileUse.empty()) {
+        std::string profile = hashFileContents(opts.profileUse);
+        if (profile.empty()) {
+            std::cerr << "error: cannot read profile " << opts.profileUse << std::endl;
+            return false;
+        }
+        buildKey += profile + "\n";
+    }
+
+    const std::string& dir = opts.incrementalDir;
+    if (sys::fs::create_directories(dir)) {
+        std::cerr << "error: cannot create " << dir << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> objects;
+    std::set<std::string> current;
+    unsigned recompiled = 0;
+    for (const std::string& name : order) {
+        std::string file = fragmentKey(units, name, buildKey) + ".o";
+        std::string path = dir + "/" + file;
+        objects.push_back(path);
+        current.insert(file);
+        if (sys::fs::exists(path)) {
+            continue;
+        }
+        if (!compileFragment(root, units, name, tm, opts, path)) {
+            return false;
+        }
+        recompiled++;
+    }
+    removeStaleFragments(dir, current);
+
+    std::cout << "incremental: " << recompiled << " of " << order.size() << " functions recompiled" << std::endl;
+
+    if (opts.sizeReport && !writeSizeReport(objects, opts.sizeReportPath)) {
+        return false;
+    }
+    if (opts.outputKind == OutputObject) {
+        return linkRelocatable(objects, opts.outputPath, opts);
+    }
+    return linkExecutable(objects, opts.outputPath, opts);
+}
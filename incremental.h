@@ -0,0 +1,27 @@
+#ifndef BOSOJOWO_INCREMENTAL_H
+#define BOSOJOWO_INCREMENTAL_H
+
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+class NBlock;
+
+/**
+ * --incremental: build ulang per fungsi.
+ *
+ * Setiap fungsi (dan kode top level sebagai `main`) jadi satu object fragmen di
+ * `opts.incrementalDir` dengan nama dari hash AST fungsi itu ditambah hash AST
+ * semua fungsi yang dipanggilnya secara transitif, opsi dan target
+ * (compilerFingerprint). Mengubah satu fungsi hanya mengubah key fungsi itu dan
+ * pemanggilnya; fragmen lain dipakai lagi dari build sebelumnya.
+ *
+ * Fragmen yang berubah di-codegen dari AST fungsi beserta callee-nya saja:
+ * callee jadi available_externally supaya tetap bisa di-inline, definisinya ada
+ * di fragmen masing-masing. Semua fragmen lalu di-link menjadi executable, atau
+ * satu object untuk -c. Fragmen yang tidak dipakai lagi dihapus.
+ */
+bool incrementalBuild(NBlock& root, int argc, char **argv, llvm::TargetMachine& tm,
+                      const CompileOptions& opts);
+
+#endif
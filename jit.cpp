@@ -0,0 +1,202 @@
+#include <llvm/ExecutionEngine/Orc/LambdaResolver.h>
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include "jit.h"
+#include "optimize.h"
+#include "thinlto.h"
+
+using namespace llvm;
+
+// module GV + stub dari CompileOnDemandLayer (LLVM 3.7), bukan kode program
+static const char *kStubsModuleSuffix = ".globals_and_stubs";
+
+JowoJIT::JowoJIT(TargetMachine& tm, PerfJITSupport *perf) :
+    tm(tm), perf(perf), mangler(tm.getDataLayout()), objectLayer(PerfNotifyLoaded(perf)),
+    compileLayer(objectLayer, orc::SimpleCompiler(tm))
+{
+    // simbol libc (printf, puts, ...) dari proses ini
+    sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+}
+
+std::string JowoJIT::mangle(const std::string& name)
+{
+    std::string mangled;
+    raw_string_ostream out(mangled);
+    mangler.getNameWithPrefix(out, name);
+    return out.str();
+}
+
+std::unique_ptr<RuntimeDyld::SymbolResolver> JowoJIT::createResolver()
+{
+    // cari dulu di module yang sudah di-JIT, lalu di proses
+    return orc::createLambdaResolver(
+        [this](const std::string& name) {
+            if (orc::JITSymbol symbol = compileLayer.findSymbol(name, false)) {
+                return RuntimeDyld::SymbolInfo(symbol.getAddress(), symbol.getFlags());
+            }
+            return RuntimeDyld::SymbolInfo(nullptr);
+        },
+        [](const std::string& name) {
+            if (uint64_t address = RTDyldMemoryManager::getSymbolAddressInProcess(name)) {
+                return RuntimeDyld::SymbolInfo(address, JITSymbolFlags::Exported);
+            }
+            return RuntimeDyld::SymbolInfo(nullptr);
+        });
+}
+
+JowoJIT::ModuleHandle JowoJIT::addModule(std::unique_ptr<Module> module)
+{
+    std::vector<std::unique_ptr<Module> > modules;
+    modules.push_back(std::move(module));
+    return compileLayer.addModuleSet(std::move(modules), make_unique<PerfMemoryManager>(perf),
+                                     createResolver());
+}
+
+void JowoJIT::addObject(object::OwningBinary<object::ObjectFile> object)
+{
+    std::vector<object::ObjectFile*> set;
+    set.push_back(object.getBinary());
+    objectLayer.addObjectSet(set, make_unique<PerfMemoryManager>(perf), createResolver());
+    // RuntimeDyld tidak menyalin object, buffer-nya harus tetap hidup
+    objects.push_back(std::move(object));
+}
+
+void JowoJIT::removeModule(ModuleHandle handle)
+{
+    compileLayer.removeModuleSet(handle);
+}
+
+uint64_t JowoJIT::getAddress(const std::string& name)
+{
+    orc::JITSymbol symbol = compileLayer.findSymbol(mangle(name), true);
+    return symbol ? symbol.getAddress() : 0;
+}
+
+JowoLazyJIT::JowoLazyJIT(TargetMachine& tm, const CompileOptions& opts) :
+    tm(tm), opts(opts), mangler(tm.getDataLayout()), objectLayer(PerfNotifyLoaded(perfSupport(opts))),
+    compileLayer(objectLayer, orc::SimpleCompiler(tm)),
+    optimizeLayer(compileLayer, [this](std::unique_ptr<Module> module) {
+        return optimizePartition(std::move(module));
+    }),
+    lazyEmitLayer(optimizeLayer),
+    callbacks(optimizeLayer, callbackMemory, getGlobalContext(), 0, 64),
+    codLayer(lazyEmitLayer, callbacks),
+    compiledFunctions(0)
+{
+    sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+}
+
+bool JowoLazyJIT::supports(TargetMachine& tm)
+{
+    return tm.getTargetTriple().getArch() == Triple::x86_64;
+}
+
+static unsigned instructionCount(Function& function)
+{
+    unsigned count = 0;
+    for (BasicBlock& bb : function) {
+        count += bb.size();
+    }
+    return count;
+}
+
+/**
+ * Salin body callee kecil (<= --import-limit) ke partisi sebagai
+ * available_externally, diulang untuk callee dari body yang baru disalin.
+ * Hanya untuk inlining, definisinya tetap partisi callee sendiri.
+ */
+unsigned JowoLazyJIT::importCallees(Module& partition)
+{
+    unsigned imported = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::vector<Function*> decls;
+        for (Function& function : partition) {
+            if (function.isDeclaration()) {
+                decls.push_back(&function);
+            }
+        }
+        for (Function *decl : decls) {
+            Function *definition = source->getFunction(decl->getName());
+            if (definition == nullptr || definition->isDeclaration() ||
+                definition->getFunctionType() != decl->getFunctionType() ||
+                instructionCount(*definition) > opts.importLimit || !isImportable(*definition)) {
+                continue;
+            }
+            importFunction(partition, *decl, *definition);
+            imported++;
+            changed = true;
+        }
+    }
+    return imported;
+}
+
+/* Dipanggil sekali per module yang di-compile, tepat sebelum di-compile. */
+std::unique_ptr<Module> JowoLazyJIT::optimizePartition(std::unique_ptr<Module> module)
+{
+    // stub hanya lompat lewat pointer, tidak perlu dioptimasi dan bukan fungsi program
+    if (module->getName().endswith(kStubsModuleSuffix)) {
+        return module;
+    }
+    for (Function& function : *module) {
+        if (!function.isDeclaration()) {
+            compiledFunctions++;
+        }
+    }
+    // tanpa inliner body callee tidak ada gunanya
+    if (source && opts.optLevel >= 2) {
+        importCallees(*module);
+    }
+    optimizeModule(*module, tm, opts, true);
+    return module;
+}
+
+std::string JowoLazyJIT::mangle(const std::string& name)
+{
+    std::string mangled;
+    raw_string_ostream out(mangled);
+    mangler.getNameWithPrefix(out, name);
+    return out.str();
+}
+
+JowoLazyJIT::ModuleHandle JowoLazyJIT::addModule(std::unique_ptr<Module> module)
+{
+    auto resolver = orc::createLambdaResolver(
+        [this](const std::string& name) {
+            if (orc::JITSymbol symbol = codLayer.findSymbol(name, false)) {
+                return RuntimeDyld::SymbolInfo(symbol.getAddress(), symbol.getFlags());
+            }
+            if (uint64_t address = RTDyldMemoryManager::getSymbolAddressInProcess(name)) {
+                return RuntimeDyld::SymbolInfo(address, JITSymbolFlags::Exported);
+            }
+            return RuntimeDyld::SymbolInfo(nullptr);
+        },
+        [](const std::string& name) {
+            return RuntimeDyld::SymbolInfo(nullptr);
+        });
+
+    // salinan sebelum CompileOnDemandLayer memecah dan mengubah module-nya
+    if (!source) {
+        std::unique_ptr<Module> copy(CloneModule(module.get()));
+        source = std::move(copy);
+    }
+
+    std::vector<std::unique_ptr<Module> > modules;
+    modules.push_back(std::move(module));
+    return codLayer.addModuleSet(std::move(modules), make_unique<PerfMemoryManager>(perfSupport(opts)),
+                                 std::move(resolver));
+}
+
+uint64_t JowoLazyJIT::getAddress(const std::string& name)
+{
+    orc::JITSymbol symbol = codLayer.findSymbol(mangle(name), true);
+    return symbol ? symbol.getAddress() : 0;
+}
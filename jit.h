@@ -0,0 +1,111 @@
+#ifndef BOSOJOWO_JIT_H
+#define BOSOJOWO_JIT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <functional>
+
+#include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/IRTransformLayer.h>
+#include <llvm/ExecutionEngine/Orc/LazyEmittingLayer.h>
+#include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/Orc/OrcTargetSupport.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/IR/Mangler.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+#include "perf.h"
+
+/**
+ * JIT ORC untuk `--jalan`: module di-compile di memori dengan TargetMachine
+ * yang sama dengan kompilasi biasa lalu di-link oleh RuntimeDyld, tanpa llc,
+ * linker maupun file sementara. Simbol yang tidak ada di module (printf, puts)
+ * dicari di proses bosojowo sendiri.
+ */
+class JowoJIT {
+    llvm::TargetMachine& tm;
+    PerfJITSupport *perf;
+    llvm::Mangler mangler;
+    llvm::orc::ObjectLinkingLayer<PerfNotifyLoaded> objectLayer;
+    llvm::orc::IRCompileLayer<llvm::orc::ObjectLinkingLayer<PerfNotifyLoaded> > compileLayer;
+    std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile> > objects;
+
+    std::unique_ptr<llvm::RuntimeDyld::SymbolResolver> createResolver();
+
+public:
+    typedef llvm::orc::IRCompileLayer<llvm::orc::ObjectLinkingLayer<PerfNotifyLoaded> >::ModuleSetHandleT ModuleHandle;
+
+    /* `perf` tidak nullptr: setiap object yang di-load didaftarkan ke perf map / jitdump. */
+    explicit JowoJIT(llvm::TargetMachine& tm, PerfJITSupport *perf = nullptr);
+
+    ModuleHandle addModule(std::unique_ptr<llvm::Module> module);
+    void removeModule(ModuleHandle handle);
+
+    /* Object yang sudah di-compile sebelumnya (mis. dari cache), langsung di-link. */
+    void addObject(llvm::object::OwningBinary<llvm::object::ObjectFile> object);
+
+    /* Alamat simbol yang sudah di-JIT, 0 apabila tidak ada. */
+    uint64_t getAddress(const std::string& name);
+
+    std::string mangle(const std::string& name);
+};
+
+/**
+ * JIT lazy untuk `--jalan --lazy`: setiap fungsi dipisah ke module sendiri
+ * (CompileOnDemandLayer) dan dipanggil lewat stub. Fungsi baru dioptimasi dan
+ * di-compile ketika stub-nya pertama kali dipanggil, jadi waktu sampai output
+ * pertama mengikuti kode yang benar-benar dijalankan, bukan ukuran program.
+ * Di partisi callee hanya deklarasi; supaya tetap bisa di-inline, body callee
+ * kecil disalin dari salinan module asal sebagai available_externally.
+ * Stub dan trampoline ORC hanya ada untuk x86-64.
+ */
+class JowoLazyJIT {
+    typedef llvm::orc::ObjectLinkingLayer<PerfNotifyLoaded> ObjectLayer;
+    typedef llvm::orc::IRCompileLayer<ObjectLayer> CompileLayer;
+    typedef std::function<std::unique_ptr<llvm::Module>(std::unique_ptr<llvm::Module>)> Transform;
+    typedef llvm::orc::IRTransformLayer<CompileLayer, Transform> OptimizeLayer;
+    typedef llvm::orc::LazyEmittingLayer<OptimizeLayer> LazyEmitLayer;
+    typedef llvm::orc::JITCompileCallbackManager<OptimizeLayer, llvm::orc::OrcX86_64> CallbackManager;
+    typedef llvm::orc::CompileOnDemandLayer<LazyEmitLayer, CallbackManager> CODLayer;
+
+    llvm::TargetMachine& tm;
+    const CompileOptions& opts;
+    llvm::Mangler mangler;
+    ObjectLayer objectLayer;
+    CompileLayer compileLayer;
+    OptimizeLayer optimizeLayer;
+    LazyEmitLayer lazyEmitLayer;
+    llvm::SectionMemoryManager callbackMemory;
+    CallbackManager callbacks;
+    CODLayer codLayer;
+    unsigned compiledFunctions;
+    std::unique_ptr<llvm::Module> source;   // sebelum dipartisi, sumber body callee
+
+    std::unique_ptr<llvm::Module> optimizePartition(std::unique_ptr<llvm::Module> module);
+    unsigned importCallees(llvm::Module& partition);
+
+public:
+    typedef CODLayer::ModuleSetHandleT ModuleHandle;
+
+    JowoLazyJIT(llvm::TargetMachine& tm, const CompileOptions& opts);
+
+    static bool supports(llvm::TargetMachine& tm);
+
+    ModuleHandle addModule(std::unique_ptr<llvm::Module> module);
+
+    /* Alamat simbol (stub untuk fungsi yang belum di-compile), 0 apabila tidak ada. */
+    uint64_t getAddress(const std::string& name);
+
+    std::string mangle(const std::string& name);
+
+    unsigned compiledCount() const { return compiledFunctions; }
+};
+
+#endif
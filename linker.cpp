@@ -0,0 +1,129 @@
+#include <iostream>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#ifdef BOSOJOWO_HAVE_LLD
+#include <lld/Driver/Driver.h>
+#endif
+
+#include "linker.h"
+
+using namespace llvm;
+
+/* libjowo_rt.a dipasang di direktori yang sama dengan binary bosojowo. */
+static std::string runtimeLibraryPath(const CompileOptions& opts)
+{
+    std::string exe = sys::fs::getMainExecutable(opts.driverPath.c_str(), (void*)&runtimeLibraryPath);
+    SmallString<256> path(sys::path::parent_path(exe));
+    sys::path::append(path, "libjowo_rt.a");
+    return path.str();
+}
+
+#ifdef BOSOJOWO_HAVE_LLD
+static bool linkInProcess(const std::vector<std::string>& objects, const std::string& output,
+                          const CompileOptions& opts)
+{
+    std::string runtime = runtimeLibraryPath(opts);
+    if (!sys::fs::exists(runtime)) {
+        std::cerr << "error: jowo runtime not found: " << runtime << std::endl;
+        return false;
+    }
+
+    std::vector<const char*> args;
+    args.push_back("ld");
+    args.push_back("-static");
+    args.push_back("-e");
+    args.push_back("_start");
+    args.push_back("-o");
+    args.push_back(output.c_str());
+    for (const std::string& object : objects) {
+        args.push_back(object.c_str());
+    }
+    args.push_back(runtime.c_str());
+
+    std::cout << "Linking " << output << " (lld)" << std::endl;
+    return lld::GnuLdDriver::linkELF(args, errs());
+}
+#endif
+
+static bool linkWithSystemDriver(const std::vector<std::string>& objects, const std::string& output,
+                                 bool relocatable = false, bool profileRuntime = false)
+{
+    // runtime profile (compiler-rt) hanya dibawa driver clang
+    const char *driver = profileRuntime ? "clang" : "cc";
+    ErrorOr<std::string> cc = sys::findProgramByName(driver);
+    if (!cc) {
+        std::cerr << "error: no linker available (build with lld or install " << driver << ")" << std::endl;
+        return false;
+    }
+
+    std::vector<const char*> args;
+    args.push_back(cc->c_str());
+    if (profileRuntime) {
+        args.push_back("-fprofile-instr-generate");
+    }
+    if (relocatable) {
+        args.push_back("-nostdlib");
+        args.push_back("-r");
+    }else{
+        args.push_back("-no-pie");
+    }
+    args.push_back("-o");
+    args.push_back(output.c_str());
+    for (const std::string& object : objects) {
+        args.push_back(object.c_str());
+    }
+    args.push_back(nullptr);
+
+    std::cout << "Linking " << output << " (" << *cc << ")" << std::endl;
+    std::string error;
+    int rc = sys::ExecuteAndWait(*cc, args.data(), nullptr, nullptr, 0, 0, &error);
+    if (rc != 0) {
+        std::cerr << "error: link failed " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool linkExecutable(const std::vector<std::string>& objects, const std::string& output,
+                    const CompileOptions& opts)
+{
+    // runtime jowo tidak bisa menulis file .profraw, pakai libc + runtime profile clang
+    if (opts.profileGenerate) {
+        return linkWithSystemDriver(objects, output, false, true);
+    }
+#ifdef BOSOJOWO_HAVE_LLD
+    // runtime jowo hanya ada untuk Linux x86-64
+    Triple triple(opts.targetTriple.empty() ? sys::getDefaultTargetTriple() : opts.targetTriple);
+    if (triple.getArch() == Triple::x86_64 && triple.isOSLinux()) {
+        return linkInProcess(objects, output, opts);
+    }
+#endif
+    return linkWithSystemDriver(objects, output);
+}
+
+bool linkRelocatable(const std::vector<std::string>& objects, const std::string& output,
+                     const CompileOptions& opts)
+{
+#ifdef BOSOJOWO_HAVE_LLD
+    Triple triple(opts.targetTriple.empty() ? sys::getDefaultTargetTriple() : opts.targetTriple);
+    if (triple.isOSBinFormatELF()) {
+        std::vector<const char*> args;
+        args.push_back("ld");
+        args.push_back("-r");
+        args.push_back("-o");
+        args.push_back(output.c_str());
+        for (const std::string& object : objects) {
+            args.push_back(object.c_str());
+        }
+        std::cout << "Linking " << output << " (lld -r)" << std::endl;
+        return lld::GnuLdDriver::linkELF(args, errs());
+    }
+#endif
+    return linkWithSystemDriver(objects, output, true);
+}
@@ -0,0 +1,23 @@
+#ifndef BOSOJOWO_LINKER_H
+#define BOSOJOWO_LINKER_H
+
+#include <string>
+#include <vector>
+
+#include "options.h"
+
+/**
+ * Link object file menjadi executable.
+ *
+ * Apabila bosojowo dibangun dengan lld, link dilakukan di dalam proses
+ * secara statis terhadap runtime jowo (libjowo_rt.a) tanpa libc dan tanpa
+ * toolchain eksternal. Tanpa lld, driver C sistem (`cc`) yang dipanggil.
+ */
+bool linkExecutable(const std::vector<std::string>& objects, const std::string& output,
+                    const CompileOptions& opts);
+
+/* Gabungkan beberapa object menjadi satu object (link relocatable, `ld -r`). */
+bool linkRelocatable(const std::vector<std::string>& objects, const std::string& output,
+                     const CompileOptions& opts);
+
+#endif
@@ -2,6 +2,8 @@
 #include <vector>
 #include <llvm/IR/Value.h>
 
+extern int yylineno;
+
 class CodeGenContext;
 class NStatement;
 class NExpression;
@@ -13,6 +15,8 @@ typedef std::vector<NVariableDeclaration*> VariableList;
 
 class Node {
 public:
+    int line;   // baris di file .jowo, untuk debug info dan remarks
+    Node() : line(yylineno) { }
     virtual ~Node() {}
     virtual llvm::Value* codeGen(CodeGenContext& context){ return nullptr; };
     virtual std::string kind(){ return "Node"; };
@@ -22,6 +26,8 @@ class NExpression : public Node {
 public:
     virtual std::string key(){ return ""; };
     virtual std::string kind(){ return "Expr"; };
+    // biaya untuk dievaluasi tanpa cabang, -1 apabila punya efek samping
+    virtual int speculationCost(){ return -1; };
 };
 
 class NVoidExpression : public NExpression {
@@ -42,6 +48,7 @@ public:
     NInteger(long long value) : value(value) { }
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "int"; };
+    virtual int speculationCost(){ return 0; };
 };
 
 class NDouble : public NExpression {
@@ -50,6 +57,7 @@ public:
     NDouble(double value) : value(value) { }
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "double"; };
+    virtual int speculationCost(){ return 0; };
 };
 
 class NIdentifier : public NExpression {
@@ -61,12 +69,13 @@ public:
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "ident=" + name; };
     virtual std::string key(){ return name; };
+    virtual int speculationCost(){ return 1; };
 };
 
 class NReturn : public NStatement {
 public:
     NExpression* lhs;
-    NReturn(NExpression* lhs) : lhs(lhs) { }
+    NReturn(NExpression* lhs) : lhs(lhs) { line = lhs->line; }
     NReturn(): lhs(new NVoidExpression()) {}
     ~NReturn(){
         if (lhs != nullptr){
@@ -83,6 +92,7 @@ public:
     NStr(const std::string& text) : text(text) {}
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "str"; };
+    virtual int speculationCost(){ return 0; };
 };
 
 class NMethodCall : public NExpression {
@@ -90,8 +100,8 @@ public:
     const NIdentifier& id;
     ExpressionList arguments;
     NMethodCall(const NIdentifier& id, ExpressionList& arguments) :
-        id(id), arguments(arguments) { }
-    NMethodCall(const NIdentifier& id) : id(id) { }
+        id(id), arguments(arguments) { line = id.line; }
+    NMethodCall(const NIdentifier& id) : id(id) { line = id.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "MethodCall"; };
 };
@@ -102,9 +112,10 @@ public:
     NExpression& lhs;
     NExpression& rhs;
     NBinaryOperator(NExpression& lhs, int op, NExpression& rhs) :
-        op(op), lhs(lhs), rhs(rhs) { }
+        op(op), lhs(lhs), rhs(rhs) { line = lhs.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "BinaryOperator"; }
+    virtual int speculationCost();
 };
 
 class NAssignment : public NExpression {
@@ -112,7 +123,7 @@ public:
     NIdentifier& lhs;
     NExpression& rhs;
     NAssignment(NIdentifier& lhs, NExpression& rhs) :
-        lhs(lhs), rhs(rhs) { }
+        lhs(lhs), rhs(rhs) { line = lhs.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
 };
 
@@ -122,6 +133,7 @@ public:
     NBlock() { }
     virtual llvm::Value* codeGen(CodeGenContext& context);
     virtual std::string kind(){ return "Block"; }
+    virtual int speculationCost();
 };
 
 class NConditionalBlock : public NExpression {
@@ -130,7 +142,7 @@ public:
     NBlock *thenStmt, *elseStmt;
     
     NConditionalBlock(NExpression& cond, NBlock* tb, NBlock* eb):
-        cond(cond), thenStmt(tb), elseStmt(eb) {}
+        cond(cond), thenStmt(tb), elseStmt(eb) { line = cond.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
 };
 
@@ -142,7 +154,7 @@ public:
     NBlock* block;
     
     NLoop(NExpression& exprFrom, NExpression& exprUntil, NBlock* block):
-        exprFrom(exprFrom), exprUntil(exprUntil), block(block){}
+        exprFrom(exprFrom), exprUntil(exprUntil), block(block) { line = exprFrom.line; }
     
     virtual llvm::Value* codeGen(CodeGenContext& context);
 };
@@ -163,8 +175,9 @@ class NExpressionStatement : public NStatement {
 public:
     NExpression& expression;
     NExpressionStatement(NExpression& expression) :
-        expression(expression) { }
+        expression(expression) { line = expression.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
+    virtual int speculationCost(){ return expression.speculationCost(); };
 };
 
 class NVariableDeclaration : public NStatement {
@@ -173,9 +186,9 @@ public:
     NIdentifier& id;
     NExpression *assignmentExpr;
     NVariableDeclaration(const NIdentifier& type, NIdentifier& id) :
-        type(type), id(id) { }
+        type(type), id(id), assignmentExpr(nullptr) { line = type.line; }
     NVariableDeclaration(const NIdentifier& type, NIdentifier& id, NExpression *assignmentExpr) :
-        type(type), id(id), assignmentExpr(assignmentExpr) { }
+        type(type), id(id), assignmentExpr(assignmentExpr) { line = type.line; }
     virtual llvm::Value* codeGen(CodeGenContext& context);
 };
 
@@ -185,13 +198,28 @@ public:
     const NIdentifier& id;
     VariableList arguments;
     NBlock& block;
+    bool isPure; // `murni`: tanpa efek samping, boleh di-memo
+    bool isHot;  // `panas`: dibuat beberapa versi per generasi CPU
     
     NFunctionDeclaration(NIdentifier* type, const NIdentifier& id,
             const VariableList& arguments, NBlock& block) :
-        type(type), id(id), arguments(arguments), block(block) { }
+        type(type), id(id), arguments(arguments), block(block), isPure(false), isHot(false) { line = id.line; }
 
     NFunctionDeclaration(NIdentifier* type, const NIdentifier& id, NBlock& block) :
-        type(type), id(id), arguments(VariableList()), block(block) { }
+        type(type), id(id), arguments(VariableList()), block(block), isPure(false), isHot(false) { line = id.line; }
+
+    virtual llvm::Value* codeGen(CodeGenContext& context);
+};
+
+class NExternDeclaration : public NStatement {
+public:
+    NIdentifier* type;
+    const NIdentifier& id;
+    VariableList arguments;
+    bool isPure;
+
+    NExternDeclaration(NIdentifier* type, const NIdentifier& id, const VariableList& arguments) :
+        type(type), id(id), arguments(arguments), isPure(false) { line = id.line; }
 
     virtual llvm::Value* codeGen(CodeGenContext& context);
 };
@@ -0,0 +1,108 @@
+#include <iostream>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Instrumentation.h>
+
+#include "hotcold.h"
+#include "optimize.h"
+#include "wholeprogram.h"
+
+using namespace llvm;
+
+/* --profile-generate: turunkan llvm.instrprof.increment menjadi counter dan data profile. */
+static void lowerProfileCounters(Module& module, const CompileOptions& opts)
+{
+    if (!opts.profileGenerate) {
+        return;
+    }
+    legacy::PassManager pm;
+    pm.add(createInstrProfilingPass(InstrProfOptions()));
+    pm.run(module);
+}
+
+bool optimizeModule(Module& module, TargetMachine& tm, const CompileOptions& opts, bool quiet)
+{
+    if (verifyModule(module, &errs())) {
+        std::cerr << "error: generated module is broken" << std::endl;
+        return false;
+    }
+
+    if (opts.wholeProgram) {
+        optimizeWholeProgram(module, opts);
+    }
+
+    if (opts.optLevel == 0) {
+        lowerProfileCounters(module, opts);
+        return true;
+    }
+
+    if (quiet) {
+        // tanpa pesan
+    }else if (opts.sizeLevel > 0) {
+        std::cout << "Optimizing -O" << (opts.sizeLevel == 1 ? "s" : "z") << "..." << std::endl;
+    }else{
+        std::cout << "Optimizing -O" << opts.optLevel << "..." << std::endl;
+    }
+
+    // instruction selection dan layout juga memilih kode yang lebih kecil
+    if (opts.sizeLevel > 0) {
+        for (Function& function : module) {
+            if (function.isDeclaration()) {
+                continue;
+            }
+            function.addFnAttr(Attribute::OptimizeForSize);
+            if (opts.sizeLevel > 1) {
+                function.addFnAttr(Attribute::MinSize);
+            }
+        }
+    }
+
+    legacy::PassManager pm;
+    legacy::FunctionPassManager fpm(&module);
+
+    pm.add(new TargetLibraryInfoWrapperPass(Triple(module.getTargetTriple())));
+    pm.add(createTargetTransformInfoWrapperPass(tm.getTargetIRAnalysis()));
+    fpm.add(createTargetTransformInfoWrapperPass(tm.getTargetIRAnalysis()));
+
+    PassManagerBuilder builder;
+    builder.OptLevel = opts.optLevel;
+    builder.SizeLevel = opts.sizeLevel;
+    if (opts.optLevel > 1) {
+        builder.Inliner = createFunctionInliningPass(opts.optLevel, opts.sizeLevel);
+    }else{
+        builder.Inliner = createAlwaysInlinerPass();
+    }
+    // vectorizer menambah kode (epilog, versi skalar), tidak untuk -Os/-Oz
+    builder.LoopVectorize = opts.optLevel > 1 && opts.sizeLevel == 0;
+    builder.SLPVectorize = opts.optLevel > 1 && opts.sizeLevel < 2;
+
+    builder.populateFunctionPassManager(fpm);
+    builder.populateModulePassManager(pm);
+    if (opts.mergeFunctions) {
+        pm.add(createMergeFunctionsPass());
+    }
+
+    fpm.doInitialization();
+    for (Module::iterator it = module.begin(); it != module.end(); it++) {
+        fpm.run(*it);
+    }
+    fpm.doFinalization();
+
+    pm.run(module);
+
+    if (opts.splitCold) {
+        splitColdCode(module, opts);
+    }
+
+    // setelah optimasi seperti clang, counter tidak menghalangi inliner
+    lowerProfileCounters(module, opts);
+
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef BOSOJOWO_OPTIMIZE_H
+#define BOSOJOWO_OPTIMIZE_H
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+/**
+ * Jalankan pipeline optimasi -O0..-O3 pada module.
+ * Analisis biaya instruksi diambil dari TargetMachine sehingga
+ * vectorizer dan inliner tahu fitur CPU target.
+ * Mengembalikan false apabila module tidak valid. `quiet` untuk JIT lazy,
+ * supaya tidak mencetak apa-apa di tengah output program.
+ */
+bool optimizeModule(llvm::Module& module, llvm::TargetMachine& tm, const CompileOptions& opts,
+                    bool quiet = false);
+
+#endif
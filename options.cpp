@@ -0,0 +1,485 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+#include "options.h"
+
+/**
+ * Ambil nilai dari opsi bentuk `--name=value`.
+ * Mengembalikan nullptr apabila arg bukan opsi tersebut.
+ */
+static const char *optionValue(const char *arg, const char *name){
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) == 0 && arg[len] == '=') {
+        return arg + len + 1;
+    }
+    return nullptr;
+}
+
+static bool endsWith(const std::string& str, const std::string& suffix){
+    return str.size() >= suffix.size() &&
+        str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static unsigned roundUpPow2(unsigned n){
+    unsigned p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+void printUsage(const char *exe){
+    std::cout << "Usage: " << exe << " [opsi] [input.jowo] [input.bc ...] -o output-file" << std::endl
+              << "       " << exe << " --jalan [opsi] [input.jowo] [input.bc ...]" << std::endl
+              << "       " << exe << " --vm [input.jowo]" << std::endl
+              << "       " << exe << " repl [opsi]" << std::endl
+              << "       tanpa input.jowo sumber dibaca dari stdin" << std::endl
+              << std::endl
+              << "Opsi:" << std::endl
+              << "  -o FILE                file output: .ll, .s, .o, selain itu executable" << std::endl
+              << "  --jalan                JIT lalu jalankan program langsung (CPU native)" << std::endl
+              << "  --lazy                 dengan --jalan: compile fungsi ketika pertama dipanggil" << std::endl
+              << "  --vm                   jalankan di interpreter bytecode (start cepat, tanpa LLVM)" << std::endl
+              << "  --tiered               interpreter dulu, fungsi panas di-JIT di thread lain" << std::endl
+              << "  --tier-threshold=N     panggilan + back-edge sebelum fungsi di-JIT (default 1000)" << std::endl
+              << "  --cache[=DIR]          simpan/pakai object dan bitcode dari kompilasi yang sama" << std::endl
+              << "  --cache-size=MB        batas ukuran cache (default 1024)" << std::endl
+              << "  --incremental[=DIR]    object per fungsi di DIR (default OUTPUT.inc), compile ulang yang berubah saja" << std::endl
+              << "  --package              -o FILE jadi launcher + bitcode, di-compile untuk CPU host saat jalan" << std::endl
+              << "  --perf[=map|jitdump]   tulis simbol kode hasil JIT untuk perf (default keduanya)" << std::endl
+              << "  -c                     tulis object file native" << std::endl
+              << "  -S                     tulis assembly native" << std::endl
+              << "  --emit-bc              tulis LLVM bitcode" << std::endl
+              << "  -fPIC                  kode position independent" << std::endl
+              << "  -j N                   generate kode native di N thread" << std::endl
+              << "  -g                     debug info DWARF lengkap (baris, fungsi, variabel)" << std::endl
+              << "  -gline-tables-only     debug info baris saja" << std::endl
+              << "  --remarks[=FORMAT]     laporan optimasi per baris, FORMAT text|yaml|json" << std::endl
+              << "  --remarks-file=FILE    tulis remarks ke FILE (yaml/json default OUTPUT.opt.yaml/.opt.json)" << std::endl
+              << "  --remarks-passes=P,..  pass yang dilaporkan, `all` untuk semua" << std::endl
+              << "                         (default inline,loop-vectorize,slp-vectorizer,loop-unroll,licm)" << std::endl
+              << "  --time                 cetak durasi setiap tahap kompilasi" << std::endl
+              << "  -O0 -O1 -O2 -O3        level optimasi (default -O0)" << std::endl
+              << "  -Os -Oz                optimasi ukuran kode (-Oz paling kecil)" << std::endl
+              << "  -fmerge-functions      lipat fungsi yang identik (ICF)" << std::endl
+              << "  -fsplit-cold           pisahkan kode dingin dari profile, fungsi ke .text.hot/.text.unlikely" << std::endl
+              << "  --size-report[=FILE]   laporan ukuran setiap fungsi" << std::endl
+              << "  --target=TRIPLE        target triple (default: host)" << std::endl
+              << "  -mcpu=CPU              CPU target, `native` untuk CPU mesin ini" << std::endl
+              << "  -march=native          sama dengan -mcpu=native" << std::endl
+              << "  -mattr=+a,-b           tambah/hapus fitur CPU" << std::endl
+              << "  --whole-program        internalize, fastcc, spesialisasi argumen konstan" << std::endl
+              << "  --spec-budget=N        batas instruksi clone spesialisasi (default 1000)" << std::endl
+              << "  -flto=thin             kompile per file ke bitcode + summary, link dengan" << std::endl
+              << "                         import fungsi kecil lintas file secara paralel" << std::endl
+              << "  --import-limit=N       instruksi maksimal fungsi yang di-import (default 100)" << std::endl
+              << "  --profile-generate     tambah counter profile, program menulis .profraw" << std::endl
+              << "  --profile-use=FILE     optimasi memakai .profdata (llvm-profdata merge)" << std::endl
+              << "  --memo                 aktifkan memoization untuk fungsi `murni`" << std::endl
+              << "  --memo-size=N          kapasitas cache memo per fungsi (default 4096)" << std::endl
+              << "  --memo-probes=N        panjang probing open-addressing (default 4)" << std::endl
+              << "  --memo-evict=replace|keep" << std::endl
+              << "                         kebijakan ketika slot penuh (default replace)" << std::endl
+              << "  --no-select            selalu pakai cabang untuk `nek`, tanpa `select`" << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, CompileOptions& opts){
+    const char *val;
+    bool explicitKind = false;
+
+    opts.driverPath = argv[0];
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "-o") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "missing file name after -o" << std::endl;
+                return false;
+            }
+            opts.outputPath = argv[++i];
+        }else if (strcmp(arg, "--jalan") == 0) {
+            opts.run = true;
+        }else if (strcmp(arg, "--lazy") == 0) {
+            opts.lazyJIT = true;
+        }else if (strcmp(arg, "--vm") == 0) {
+            opts.vm = true;
+        }else if (strcmp(arg, "--tiered") == 0) {
+            opts.tiered = true;
+        }else if ((val = optionValue(arg, "--tier-threshold")) != nullptr) {
+            int n = atoi(val);
+            if (n <= 0) {
+                std::cerr << "invalid --tier-threshold: " << val << std::endl;
+                return false;
+            }
+            opts.tierThreshold = (unsigned)n;
+        }else if (strcmp(arg, "--cache") == 0) {
+            opts.cache = true;
+        }else if ((val = optionValue(arg, "--cache")) != nullptr) {
+            opts.cache = true;
+            opts.cacheDir = val;
+        }else if ((val = optionValue(arg, "--cache-size")) != nullptr) {
+            int n = atoi(val);
+            if (n <= 0) {
+                std::cerr << "invalid --cache-size: " << val << std::endl;
+                return false;
+            }
+            opts.cacheSize = (uint64_t)n << 20;
+        }else if (strcmp(arg, "--incremental") == 0) {
+            opts.incremental = true;
+        }else if ((val = optionValue(arg, "--incremental")) != nullptr) {
+            opts.incremental = true;
+            opts.incrementalDir = val;
+        }else if (strcmp(arg, "--package") == 0) {
+            opts.package = true;
+        }else if (strcmp(arg, "--perf") == 0) {
+            opts.perfMap = true;
+            opts.perfJitdump = true;
+        }else if ((val = optionValue(arg, "--perf")) != nullptr) {
+            if (strcmp(val, "map") == 0) {
+                opts.perfMap = true;
+            }else if (strcmp(val, "jitdump") == 0) {
+                opts.perfJitdump = true;
+            }else{
+                std::cerr << "invalid --perf: " << val << std::endl;
+                return false;
+            }
+        }else if (strcmp(arg, "-c") == 0) {
+            opts.outputKind = OutputObject;
+            explicitKind = true;
+        }else if (strcmp(arg, "--emit-bc") == 0) {
+            opts.outputKind = OutputBitcode;
+            explicitKind = true;
+        }else if (strcmp(arg, "-S") == 0) {
+            opts.outputKind = OutputAssembly;
+            explicitKind = true;
+        }else if (strncmp(arg, "-j", 2) == 0) {
+            const char *count = arg[2] != '\0' ? arg + 2 : (i + 1 < argc ? argv[++i] : "");
+            int n = atoi(count);
+            if (n <= 0) {
+                std::cerr << "invalid -j: " << count << std::endl;
+                return false;
+            }
+            opts.jobs = (unsigned)n;
+        }else if (strcmp(arg, "-fPIC") == 0) {
+            opts.relocPIC = true;
+        }else if (strcmp(arg, "-g") == 0) {
+            opts.debugLevel = DebugFull;
+        }else if (strcmp(arg, "-gline-tables-only") == 0) {
+            if (opts.debugLevel < DebugLineTables) {
+                opts.debugLevel = DebugLineTables;
+            }
+        }else if (strcmp(arg, "--remarks") == 0) {
+            opts.remarks = true;
+        }else if ((val = optionValue(arg, "--remarks")) != nullptr) {
+            opts.remarks = true;
+            if (strcmp(val, "text") == 0) {
+                opts.remarksFormat = RemarkText;
+            }else if (strcmp(val, "yaml") == 0) {
+                opts.remarksFormat = RemarkYAML;
+            }else if (strcmp(val, "json") == 0) {
+                opts.remarksFormat = RemarkJSON;
+            }else{
+                std::cerr << "invalid --remarks: " << val << std::endl;
+                return false;
+            }
+        }else if ((val = optionValue(arg, "--remarks-file")) != nullptr) {
+            opts.remarks = true;
+            opts.remarksPath = val;
+        }else if ((val = optionValue(arg, "--remarks-passes")) != nullptr) {
+            opts.remarks = true;
+            opts.remarksPasses = val;
+        }else if (strcmp(arg, "--time") == 0) {
+            opts.timePhases = true;
+        }else if (arg[0] == '-' && arg[1] == 'O' && arg[2] >= '0' && arg[2] <= '3' && arg[3] == '\0') {
+            opts.optLevel = (unsigned)(arg[2] - '0');
+            opts.sizeLevel = 0;
+        }else if (strcmp(arg, "-Os") == 0 || strcmp(arg, "-Oz") == 0) {
+            opts.optLevel = 2;
+            opts.sizeLevel = arg[2] == 's' ? 1 : 2;
+        }else if (strcmp(arg, "-fmerge-functions") == 0) {
+            opts.mergeFunctions = true;
+        }else if (strcmp(arg, "-fsplit-cold") == 0) {
+            opts.splitCold = true;
+        }else if (strcmp(arg, "--size-report") == 0) {
+            opts.sizeReport = true;
+        }else if ((val = optionValue(arg, "--size-report")) != nullptr) {
+            opts.sizeReport = true;
+            opts.sizeReportPath = val;
+        }else if ((val = optionValue(arg, "--target")) != nullptr) {
+            opts.targetTriple = val;
+        }else if ((val = optionValue(arg, "-mcpu")) != nullptr || (val = optionValue(arg, "-march")) != nullptr) {
+            opts.cpu = val;
+        }else if ((val = optionValue(arg, "-mattr")) != nullptr) {
+            opts.features = val;
+        }else if (strcmp(arg, "--whole-program") == 0) {
+            opts.wholeProgram = true;
+        }else if ((val = optionValue(arg, "--spec-budget")) != nullptr) {
+            int n = atoi(val);
+            if (n < 0) {
+                std::cerr << "invalid --spec-budget: " << val << std::endl;
+                return false;
+            }
+            opts.specializeBudget = (unsigned)n;
+        }else if (strcmp(arg, "-flto=thin") == 0) {
+            opts.thinLTO = true;
+        }else if ((val = optionValue(arg, "--import-limit")) != nullptr) {
+            int n = atoi(val);
+            if (n < 0) {
+                std::cerr << "invalid --import-limit: " << val << std::endl;
+                return false;
+            }
+            opts.importLimit = (unsigned)n;
+        }else if (strcmp(arg, "--profile-generate") == 0) {
+            opts.profileGenerate = true;
+        }else if ((val = optionValue(arg, "--profile-use")) != nullptr) {
+            opts.profileUse = val;
+        }else if (strcmp(arg, "--memo") == 0) {
+            opts.memoize = true;
+        }else if ((val = optionValue(arg, "--memo-size")) != nullptr) {
+            int n = atoi(val);
+            if (n <= 0) {
+                std::cerr << "invalid --memo-size: " << val << std::endl;
+                return false;
+            }
+            opts.memoize = true;
+            opts.memoCapacity = roundUpPow2((unsigned)n);
+        }else if ((val = optionValue(arg, "--memo-probes")) != nullptr) {
+            int n = atoi(val);
+            if (n <= 0) {
+                std::cerr << "invalid --memo-probes: " << val << std::endl;
+                return false;
+            }
+            opts.memoProbes = (unsigned)n;
+        }else if ((val = optionValue(arg, "--memo-evict")) != nullptr) {
+            if (strcmp(val, "replace") == 0) {
+                opts.memoEviction = MemoEvictReplace;
+            }else if (strcmp(val, "keep") == 0) {
+                opts.memoEviction = MemoEvictKeep;
+            }else{
+                std::cerr << "invalid --memo-evict: " << val << std::endl;
+                return false;
+            }
+        }else if (strcmp(arg, "--no-select") == 0) {
+            opts.selectConditionals = false;
+        }else if (arg[0] == '-' && arg[1] != '\0') {
+            std::cerr << "unknown option " << arg << std::endl;
+            return false;
+        }else if (i == 1 && strcmp(arg, "repl") == 0) {
+            opts.repl = true;
+        }else if (endsWith(arg, ".jowo")) {
+            if (!opts.sourcePath.empty()) {
+                std::cerr << "only one .jowo source per compilation" << std::endl;
+                return false;
+            }
+            opts.sourcePath = arg;
+        }else if (endsWith(arg, ".bc")) {
+            opts.moduleInputs.push_back(arg);
+        }else{
+            opts.outputPath = arg;
+        }
+    }
+
+    // tanpa -c/-S jenis output ditebak dari ekstensi
+    if (!explicitKind) {
+        if (endsWith(opts.outputPath, ".o")) {
+            opts.outputKind = OutputObject;
+        }else if (endsWith(opts.outputPath, ".bc")) {
+            opts.outputKind = OutputBitcode;
+        }else if (endsWith(opts.outputPath, ".s")) {
+            opts.outputKind = OutputAssembly;
+        }else if (!endsWith(opts.outputPath, ".ll")) {
+            opts.outputKind = OutputExecutable;
+        }
+    }
+
+    // validasi untuk semua mode, sebelum --package, repl, --vm dan --tiered kembali di bawah
+
+    // --jalan, --vm, --tiered, repl dan --package saling eksklusif
+    int modes = (int)opts.run + (int)opts.vm + (int)opts.tiered + (int)opts.repl + (int)opts.package;
+    if (modes > 1) {
+        std::cerr << "--jalan, --vm, --tiered, repl and --package cannot be combined" << std::endl;
+        return false;
+    }
+
+    // mode tersebut tidak menulis object, jadi tidak bisa dipecah per file atau per fungsi
+    if (modes > 0 && (opts.thinLTO || opts.incremental || opts.profileGenerate)) {
+        std::cerr << "--jalan, --vm, --tiered, repl and --package cannot be combined with -flto=thin, --incremental or --profile-generate" << std::endl;
+        return false;
+    }
+
+    // remarks butuh lokasi baris di setiap instruksi
+    if (opts.remarks && opts.debugLevel == DebugNone) {
+        opts.debugLevel = DebugLineTables;
+    }
+
+    // yaml/json untuk tool, selalu ke file supaya tidak tercampur output lain di stdout
+    if (opts.remarks && opts.remarksFormat != RemarkText && opts.remarksPath.empty()) {
+        std::string base = opts.outputPath;
+        if (base.empty()) {
+            base = opts.sourcePath;
+            if (endsWith(base, ".jowo")) {
+                base.erase(base.size() - 5);
+            }
+        }
+        if (base.empty()) {
+            base = "jowo";
+        }
+        opts.remarksPath = base + (opts.remarksFormat == RemarkYAML ? ".opt.yaml" : ".opt.json");
+    }
+
+    if (opts.splitCold && opts.profileUse.empty()) {
+        std::cerr << "warning: -fsplit-cold needs --profile-use to know which code is cold" << std::endl;
+    }
+
+    if (opts.profileGenerate && !opts.profileUse.empty()) {
+        std::cerr << "--profile-generate and --profile-use cannot be combined" << std::endl;
+        return false;
+    }
+
+    if (opts.memoProbes > opts.memoCapacity) {
+        opts.memoProbes = opts.memoCapacity;
+    }
+
+    if ((opts.perfMap || opts.perfJitdump) && !opts.run && !opts.tiered && !opts.repl) {
+        std::cerr << "warning: --perf only applies to JIT-compiled code" << std::endl;
+    }
+
+    if (opts.lazyJIT && !opts.run) {
+        std::cerr << "warning: --lazy only applies to --jalan" << std::endl;
+    }
+
+    if (opts.thinLTO) {
+        if (!opts.sourcePath.empty() && !opts.moduleInputs.empty()) {
+            std::cerr << "-flto=thin: compile .jowo files and link .bc files in separate runs" << std::endl;
+            return false;
+        }
+        // tahap kompile selalu menghasilkan bitcode untuk tahap link
+        if (!opts.sourcePath.empty() && opts.outputKind != OutputBitcode) {
+            std::cerr << "warning: -flto=thin writes bitcode for " << opts.sourcePath << std::endl;
+            opts.outputKind = OutputBitcode;
+        }
+        if (opts.wholeProgram) {
+            std::cerr << "warning: --whole-program is ignored with -flto=thin" << std::endl;
+            opts.wholeProgram = false;
+        }
+    }
+
+    // --incremental: satu .jowo, fragmen per fungsi di-link jadi executable atau object
+    if (opts.incremental) {
+        if (opts.thinLTO || opts.profileGenerate) {
+            std::cerr << "--incremental cannot be combined with -flto=thin or --profile-generate" << std::endl;
+            return false;
+        }
+        if (opts.sourcePath.empty() || !opts.moduleInputs.empty()) {
+            std::cerr << "--incremental builds a single .jowo file" << std::endl;
+            return false;
+        }
+        if (opts.outputKind != OutputExecutable && opts.outputKind != OutputObject) {
+            std::cerr << "--incremental writes an executable or an object file" << std::endl;
+            return false;
+        }
+        if (opts.wholeProgram) {
+            std::cerr << "warning: --whole-program is ignored with --incremental, every function is exported" << std::endl;
+            opts.wholeProgram = false;
+        }
+        if (opts.jobs > 1) {
+            std::cerr << "warning: -j is ignored with --incremental" << std::endl;
+            opts.jobs = 1;
+        }
+        if (opts.cache) {
+            std::cerr << "warning: --cache is ignored with --incremental" << std::endl;
+            opts.cache = false;
+        }
+        if (opts.incrementalDir.empty()) {
+            opts.incrementalDir = opts.outputPath + ".inc";
+        }
+    }
+
+    // --package mengurus cache-nya sendiri
+    if (opts.cache && !opts.package) {
+        if (opts.run || opts.vm || opts.tiered || opts.repl || opts.sourcePath.empty()) {
+            std::cerr << "warning: --cache only applies to compiling a .jowo file to a file" << std::endl;
+            opts.cache = false;
+        }else if (opts.outputKind != OutputObject && opts.outputKind != OutputBitcode &&
+                  opts.outputKind != OutputExecutable) {
+            std::cerr << "warning: --cache only stores objects and bitcode" << std::endl;
+            opts.cache = false;
+        }else if (opts.remarks || opts.sizeReport) {
+            std::cerr << "warning: --cache is disabled with --remarks and --size-report, they need a full compile" << std::endl;
+            opts.cache = false;
+        }
+    }
+
+    // --package: bitcode untuk CPU apa saja, CPU host dipilih oleh launcher
+    if (opts.package) {
+        if (!opts.targetTriple.empty()) {
+            std::cerr << "--package builds for the host architecture, the launcher is this bosojowo binary" << std::endl;
+            return false;
+        }
+        if (!opts.cpu.empty() || !opts.features.empty()) {
+            std::cerr << "warning: -mcpu and -mattr are ignored with --package, code is compiled for the CPU it runs on" << std::endl;
+            opts.cpu.clear();
+            opts.features.clear();
+        }
+        if (opts.cache) {
+            std::cerr << "warning: --cache is ignored with --package, the launcher caches its own objects" << std::endl;
+            opts.cache = false;
+        }
+        if (opts.optLevel == 0) {
+            opts.optLevel = 2;
+        }
+        return !opts.outputPath.empty();
+    }
+
+    // repl: JIT di mesin ini, satu entri per statement/fungsi
+    if (opts.repl) {
+        if (!opts.sourcePath.empty() || !opts.moduleInputs.empty()) {
+            std::cerr << "repl reads from stdin and takes no input files" << std::endl;
+            return false;
+        }
+        if (opts.cpu.empty()) {
+            opts.cpu = "native";
+        }
+        opts.wholeProgram = false;
+        return true;
+    }
+
+    if (opts.vm) {
+        if (!opts.moduleInputs.empty()) {
+            std::cerr << "--vm runs a single .jowo source and cannot take .bc inputs" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (opts.tiered) {
+        if (!opts.moduleInputs.empty()) {
+            std::cerr << "--tiered runs a single .jowo source and cannot take .bc inputs" << std::endl;
+            return false;
+        }
+        // tingkat native selalu dioptimasi untuk mesin ini
+        if (opts.optLevel == 0) {
+            opts.optLevel = 2;
+        }
+        if (opts.cpu.empty()) {
+            opts.cpu = "native";
+        }
+        opts.wholeProgram = false;
+        return true;
+    }
+
+    if (opts.run) {
+        if (opts.lazyJIT && opts.wholeProgram) {
+            std::cerr << "warning: --whole-program is ignored with --lazy" << std::endl;
+            opts.wholeProgram = false;
+        }
+        // JIT selalu jalan di mesin ini
+        if (opts.cpu.empty()) {
+            opts.cpu = "native";
+        }
+    }
+
+    return opts.run || !opts.outputPath.empty();
+}
@@ -0,0 +1,116 @@
+#ifndef BOSOJOWO_OPTIONS_H
+#define BOSOJOWO_OPTIONS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Kebijakan cache memo ketika semua slot probe sudah terisi. */
+enum MemoEviction {
+    MemoEvictReplace,   // timpa slot asal (home slot)
+    MemoEvictKeep       // jangan simpan, entri lama tetap
+};
+
+/* Jenis file output. */
+enum OutputKind {
+    OutputIR,           // LLVM IR teks (.ll)
+    OutputAssembly,     // assembly native (.s), -S
+    OutputObject,       // object file (.o), -c
+    OutputBitcode,      // LLVM bitcode (.bc), --emit-bc
+    OutputExecutable    // executable, di-link langsung
+};
+
+/* Level debug info DWARF. */
+enum DebugLevel {
+    DebugNone,
+    DebugLineTables,    // hanya baris, -gline-tables-only (juga untuk --remarks)
+    DebugFull           // -g
+};
+
+/* Format output --remarks. */
+enum RemarkFormat {
+    RemarkText,         // file:baris: remark: ..., seperti diagnostic compiler
+    RemarkYAML,
+    RemarkJSON
+};
+
+/**
+ * Opsi kompilasi dari command line.
+ */
+struct CompileOptions {
+    std::string driverPath;     // argv[0], untuk mencari runtime jowo
+    std::string outputPath;
+    std::string sourcePath;                 // .jowo, kosong berarti stdin
+    std::vector<std::string> moduleInputs;  // .bc dari run sebelumnya
+    OutputKind outputKind = OutputIR;
+    bool timePhases = false;    // --time: cetak durasi setiap tahap
+    bool run = false;           // --jalan: JIT lalu jalankan langsung, tanpa file output
+    bool lazyJIT = false;       // --lazy: fungsi di-JIT ketika pertama kali dipanggil
+    bool vm = false;            // --vm: jalankan di interpreter bytecode, tanpa LLVM
+    bool repl = false;          // `bosojowo repl`: baca dan jalankan per entri
+    bool tiered = false;        // --tiered: interpreter dulu, fungsi panas di-JIT di belakang
+    unsigned tierThreshold = 1000;  // panggilan + back-edge sebelum fungsi di-compile
+    // --cache[=DIR]: object/bitcode dari kompilasi sebelumnya yang inputnya sama
+    bool cache = false;
+    std::string cacheDir;           // kosong berarti defaultCacheDirectory()
+    uint64_t cacheSize = 1024ull << 20; // --cache-size=MB, entri lama dihapus setelah lewat
+
+    // --incremental[=DIR]: object per fungsi dari build sebelumnya, hanya yang berubah di-compile ulang
+    bool incremental = false;
+    std::string incrementalDir;     // kosong berarti OUTPUT.inc
+
+    bool package = false;       // --package: launcher + bitcode generic, di-compile untuk CPU host saat jalan
+
+    // --perf[=map|jitdump]: daftarkan kode hasil JIT ke perf
+    bool perfMap = false;           // /tmp/perf-PID.map
+    bool perfJitdump = false;       // /tmp/jit-PID.dump untuk `perf inject --jit`
+
+    // target: kosong berarti triple host dan CPU generic
+    std::string targetTriple;
+    std::string cpu;            // -mcpu, "native" untuk CPU mesin ini
+    std::string features;       // -mattr, mis. "+avx2,+fma"
+    unsigned optLevel = 0;      // -O0..-O3
+    unsigned sizeLevel = 0;     // -Os = 1, -Oz = 2
+    bool relocPIC = false;      // -fPIC
+    unsigned jobs = 1;          // -j N: thread untuk generate kode native
+
+    // --whole-program: module tertutup, hanya `main` yang diekspor
+    bool wholeProgram = false;
+    unsigned specializeBudget = 1000; // instruksi maksimal hasil clone spesialisasi
+
+    // -flto=thin: .jowo jadi bitcode dengan summary, .bc di-link dengan import lintas file
+    bool thinLTO = false;
+    unsigned importLimit = 100;     // instruksi maksimal fungsi yang di-import
+
+    DebugLevel debugLevel = DebugNone;
+
+    // --remarks: laporan optimasi (berhasil/gagal/analisis) per baris .jowo
+    bool remarks = false;
+    RemarkFormat remarksFormat = RemarkText;
+    std::string remarksPath;        // kosong berarti stderr, yaml/json default OUTPUT.opt.yaml/.opt.json
+    std::string remarksPasses = "inline,loop-vectorize,slp-vectorizer,loop-unroll,licm";
+
+    // ukuran kode
+    bool mergeFunctions = false;    // -fmerge-functions: fungsi identik dilipat jadi satu
+    bool splitCold = false;         // -fsplit-cold: bagian dingin dipisah, fungsi ke .text.hot/.text.unlikely
+    bool sizeReport = false;        // --size-report[=FILE]: ukuran setiap fungsi di object
+    std::string sizeReportPath;     // kosong berarti stdout
+
+    // PGO: counter di kode hasil kompile, atau pakai .profdata hasil run sebelumnya
+    bool profileGenerate = false;   // --profile-generate
+    std::string profileUse;         // --profile-use=FILE
+
+    // memoization untuk fungsi `murni`
+    bool memoize = false;
+    unsigned memoCapacity = 4096;   // jumlah slot, dibulatkan ke pangkat 2
+    unsigned memoProbes = 4;        // panjang linear probing
+    MemoEviction memoEviction = MemoEvictReplace;
+
+    // conditional dengan arm kecil tanpa efek samping jadi `select`
+    bool selectConditionals = true;
+};
+
+bool parseOptions(int argc, char **argv, CompileOptions& opts);
+void printUsage(const char *exe);
+
+#endif
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <llvm/Bitcode/ReaderWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "cache.h"
+#include "jit.h"
+#include "optimize.h"
+#include "package.h"
+#include "silence.h"
+#include "target.h"
+
+using namespace llvm;
+
+static const char kPackageMagic[8] = { 'J', 'O', 'W', 'O', 'P', 'K', 'G', '1' };
+
+// ditulis di akhir file package, setelah bitcode
+struct PackageTrailer {
+    char magic[8];
+    uint64_t bitcodeSize;
+};
+
+static const char *kSelfExe = "/proc/self/exe";
+
+bool writePackage(Module& module, const std::string& path)
+{
+    ErrorOr<std::unique_ptr<MemoryBuffer> > launcher = MemoryBuffer::getFile(kSelfExe);
+    if (!launcher) {
+        std::cerr << "error: cannot read the bosojowo executable: " << launcher.getError().message() << std::endl;
+        return false;
+    }
+
+    std::string bitcode;
+    raw_string_ostream bitcodeOut(bitcode);
+    WriteBitcodeToFile(&module, bitcodeOut);
+    bitcodeOut.flush();
+
+    PackageTrailer trailer;
+    memcpy(trailer.magic, kPackageMagic, sizeof(trailer.magic));
+    trailer.bitcodeSize = bitcode.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "error: cannot open " << path << std::endl;
+        return false;
+    }
+    out.write((*launcher)->getBufferStart(), (*launcher)->getBufferSize());
+    out.write(bitcode.data(), bitcode.size());
+    out.write((const char *)&trailer, sizeof(trailer));
+    out.close();
+    if (!out || chmod(path.c_str(), 0755) != 0) {
+        std::cerr << "error: cannot write " << path << std::endl;
+        return false;
+    }
+
+    std::cout << "Package: " << (*launcher)->getBufferSize() << " bytes launcher, "
+              << bitcode.size() << " bytes bitcode" << std::endl;
+    return true;
+}
+
+bool readPackagedBitcode(std::string& bitcode)
+{
+    std::ifstream in(kSelfExe, std::ios::binary);
+    if (!in || !in.seekg(-(std::streamoff)sizeof(PackageTrailer), std::ios::end)) {
+        return false;
+    }
+    PackageTrailer trailer;
+    if (!in.read((char *)&trailer, sizeof(trailer)) ||
+        memcmp(trailer.magic, kPackageMagic, sizeof(trailer.magic)) != 0) {
+        return false;
+    }
+
+    std::streamoff offset = (std::streamoff)(sizeof(trailer) + trailer.bitcodeSize);
+    bitcode.resize(trailer.bitcodeSize);
+    return in.seekg(-offset, std::ios::end) && in.read(&bitcode[0], bitcode.size());
+}
+
+/* Object dari run sebelumnya di mesin ini, kosong apabila belum ada atau rusak. */
+static object::OwningBinary<object::ObjectFile> loadCachedObject(CompileCache& cache, const std::string& name)
+{
+    std::string data;
+    if (!cache.load(name, data)) {
+        return object::OwningBinary<object::ObjectFile>();
+    }
+    std::unique_ptr<MemoryBuffer> buffer = MemoryBuffer::getMemBufferCopy(data, name);
+    ErrorOr<std::unique_ptr<object::ObjectFile> > object =
+        object::ObjectFile::createObjectFile(buffer->getMemBufferRef());
+    if (!object) {
+        return object::OwningBinary<object::ObjectFile>();
+    }
+    return object::OwningBinary<object::ObjectFile>(std::move(*object), std::move(buffer));
+}
+
+/* Bitcode generic -> object untuk CPU host. */
+static object::OwningBinary<object::ObjectFile> compileForHost(const std::string& bitcode, TargetMachine& tm,
+                                                             const CompileOptions& options)
+{
+    ErrorOr<std::unique_ptr<Module> > module =
+        parseBitcodeFile(MemoryBufferRef(bitcode, "package"), getGlobalContext());
+    if (!module) {
+        std::cerr << "error: broken package bitcode: " << module.getError().message() << std::endl;
+        return object::OwningBinary<object::ObjectFile>();
+    }
+    configureModuleForTarget(**module, tm);
+
+    // atribut CPU generic dari saat packaging diganti CPU host,
+    // versi `panas` tetap dengan CPU-nya masing-masing
+    AttrBuilder generic;
+    generic.addAttribute("target-cpu");
+    generic.addAttribute("target-features");
+    for (Function& function : **module) {
+        if (function.getFnAttribute("target-cpu").getValueAsString() == "generic") {
+            function.removeAttributes(AttributeSet::FunctionIndex,
+                AttributeSet::get(getGlobalContext(), AttributeSet::FunctionIndex, generic));
+        }
+    }
+    setFunctionTargetAttributes(**module, tm);
+
+    if (!optimizeModule(**module, tm, options, true)) {
+        return object::OwningBinary<object::ObjectFile>();
+    }
+    orc::SimpleCompiler compile(tm);
+    return compile(**module);
+}
+
+int runPackage(const std::string& bitcode)
+{
+    CompileOptions options;
+    options.run = true;
+    options.cpu = "native";
+    options.optLevel = 2;
+
+    // pesan bosojowo ke std::cout bukan untuk pengguna program,
+    // dibungkam sampai kode hasil compile siap dijalankan
+    SilenceStdout silence;
+    TargetMachine *tm = createTargetMachine(options);
+    if (tm == nullptr) {
+        return 2;
+    }
+
+    std::string hostKey = std::string(LLVM_VERSION_STRING) + "|" + tm->getTargetTriple().str() + "|" +
+                          tm->getTargetCPU().str() + "|" + tm->getTargetFeatureString().str();
+    std::string name = hashHex(bitcode) + "-" + hashHex(hostKey) + ".o";
+
+    // cache yang sama dengan --cache, ikut batas ukurannya
+    CompileCache cache(defaultCacheDirectory(), options.cacheSize);
+    object::OwningBinary<object::ObjectFile> object = loadCachedObject(cache, name);
+    if (object.getBinary() == nullptr) {
+        object = compileForHost(bitcode, *tm, options);
+        if (object.getBinary() == nullptr) {
+            return 2;
+        }
+        cache.save(name, object.getBinary()->getData());
+    }
+
+    JowoJIT jit(*tm);
+    jit.addObject(std::move(object));
+    uint64_t address = jit.getAddress("main");
+    if (address == 0) {
+        std::cerr << "error: package has no main" << std::endl;
+        return 2;
+    }
+    silence.restore();
+
+    void (*entry)() = (void (*)())(intptr_t)address;
+    entry();
+    fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef BOSOJOWO_PACKAGE_H
+#define BOSOJOWO_PACKAGE_H
+
+#include <string>
+
+#include <llvm/IR/Module.h>
+
+/**
+ * --package: satu executable untuk semua server dengan arsitektur yang sama.
+ *
+ * Isinya salinan bosojowo ini (launcher) ditambah bitcode program yang sudah
+ * dioptimasi untuk CPU generic, ditutup trailer `JOWOPKG1` + ukuran bitcode.
+ * Saat dijalankan, launcher meng-compile bitcode untuk CPU host (-O2, fitur CPU
+ * host) lalu menyimpan object-nya di cache (lihat runPackage), jadi run
+ * berikutnya di mesin yang sama langsung me-load kode native.
+ */
+bool writePackage(llvm::Module& module, const std::string& path);
+
+/* Bitcode yang ditempel di executable proses ini, false apabila bukan package. */
+bool readPackagedBitcode(std::string& bitcode);
+
+/**
+ * Jalankan bitcode package. Object disimpan di CompileCache direktori default
+ * (cache.h) dengan nama dari hash bitcode dan hash versi LLVM + triple + CPU +
+ * fitur CPU host. Mengembalikan exit status.
+ */
+int runPackage(const std::string& bitcode);
+
+#endif
@@ -31,6 +31,7 @@
 %token <token> TLPAREN TRPAREN TLBRACE TRBRACE TCOMMA TDOT TDDOT TRETN TFUNC TBLOCKBEGIN TBLOCKEND TIF TTHEN TELSE
 %token <token> TPLUS TMINUS TMUL TDIV
 %token <token> TLOOP TUNTIL
+%token <token> TPURE THOT TEXTERN
 
 /* Define the type of node our nonterminal symbols represent.
    The types refer to the %union declaration above. Ex: when
@@ -42,7 +43,7 @@
 %type <varvec> func_decl_args
 %type <exprvec> call_args
 %type <block> program stmts block
-%type <stmt> stmt var_decl func_decl
+%type <stmt> stmt var_decl func_decl extern_decl
 %type <token> comparison
 
 /* Operator precedence for mathematical operators */
@@ -60,7 +61,7 @@ stmts : stmt { $$ = new NBlock(); $$->statements.push_back($<stmt>1); }
       | stmts stmt { $1->statements.push_back($<stmt>2); }
       ;
 
-stmt : var_decl | func_decl
+stmt : var_decl | func_decl | extern_decl
      | TRETN expr { $$ = new NReturn($2); }
      | TRETN { $$ = new NReturn(); }
      | expr { $$ = new NExpressionStatement(*$1); }
@@ -80,8 +81,18 @@ func_decl : TFUNC ident TLPAREN func_decl_args TRPAREN TDDOT ident block
             { $$ = new NFunctionDeclaration($7, *$2, *$4, *$8); delete $4; }
           | TFUNC ident TLPAREN func_decl_args TRPAREN block { $$ = new NFunctionDeclaration(nullptr, *$2, *$4, *$6); delete $4; }
           | TFUNC ident TLPAREN TRPAREN block { $$ = new NFunctionDeclaration(nullptr, *$2, *$5); }
+          | TPURE func_decl { static_cast<NFunctionDeclaration*>($2)->isPure = true; $$ = $2; }
+          | THOT func_decl { static_cast<NFunctionDeclaration*>($2)->isHot = true; $$ = $2; }
           ;
 
+/* fungsi yang didefinisikan di file .jowo lain */
+extern_decl : TEXTERN TFUNC ident TLPAREN func_decl_args TRPAREN TDDOT ident
+              { $$ = new NExternDeclaration($8, *$3, *$5); delete $5; }
+            | TEXTERN TFUNC ident TLPAREN func_decl_args TRPAREN
+              { $$ = new NExternDeclaration(nullptr, *$3, *$5); delete $5; }
+            | TPURE extern_decl { static_cast<NExternDeclaration*>($2)->isPure = true; $$ = $2; }
+            ;
+
 func_decl_args : { $$ = new VariableList(); }
           | var_decl { $$ = new VariableList(); $$->push_back($<var_decl>1); }
           | func_decl_args TCOMMA var_decl { $1->push_back($<var_decl>3); }
@@ -95,7 +106,7 @@ numeric : TINTEGER { $$ = new NInteger(atol($1->c_str())); delete $1; }
         ;
 
 conditional : TIF expr TTHEN stmts TELSE stmts { $$ = new NConditionalBlock(*$2, $4, $6); }
-            | TIF expr TTHEN block { $$ = $4; }
+            | TIF expr TTHEN block { $$ = new NConditionalBlock(*$2, $4, new NBlock()); }
             ;
 
 expr : ident TEQUAL expr { $$ = new NAssignment(*$<ident>1, *$3); }
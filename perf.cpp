@@ -0,0 +1,275 @@
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <llvm/DebugInfo/DWARF/DWARFContext.h>
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Support/ELF.h>
+
+#include "perf.h"
+
+using namespace llvm;
+using namespace llvm::object;
+
+// format jitdump: tools/perf/Documentation/jitdump-specification.txt
+static const uint32_t kJitdumpMagic = 0x4A695444;   // "JiTD"
+static const uint32_t kJitdumpVersion = 1;
+static const uint32_t kJitCodeLoad = 0;
+static const uint32_t kJitCodeDebugInfo = 2;
+
+struct JitdumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct JitdumpRecord {
+    uint32_t id;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+struct JitdumpCodeLoad {
+    JitdumpRecord record;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddress;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+    // diikuti nama (diakhiri \0) lalu byte kode
+};
+
+struct JitdumpDebugInfo {
+    JitdumpRecord record;
+    uint64_t codeAddress;
+    uint64_t entries;
+    // diikuti entri { u64 alamat, u32 baris, u32 discriminator, nama file \0 }
+};
+
+/* Jam yang sama dengan `perf record -k 1`. */
+static uint64_t monotonicNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t elfMachine()
+{
+#if defined(__x86_64__)
+    return ELF::EM_X86_64;
+#elif defined(__i386__)
+    return ELF::EM_386;
+#elif defined(__aarch64__)
+    return ELF::EM_AARCH64;
+#elif defined(__arm__)
+    return ELF::EM_ARM;
+#else
+    return ELF::EM_NONE;
+#endif
+}
+
+PerfJITSupport::PerfJITSupport(bool perfMap, bool jitdump) :
+    mapFile(nullptr), dumpFile(nullptr), marker(nullptr), markerSize(0), codeIndex(0)
+{
+    char path[64];
+
+    if (perfMap) {
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+        mapFile = fopen(path, "w");
+        if (mapFile == nullptr) {
+            std::cerr << "warning: cannot open " << path << std::endl;
+        }
+    }
+
+    if (jitdump) {
+        snprintf(path, sizeof(path), "/tmp/jit-%d.dump", (int)getpid());
+        int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (fd < 0) {
+            std::cerr << "warning: cannot open " << path << std::endl;
+            return;
+        }
+        // perf inject mencari file jitdump dari mmap executable ini
+        markerSize = sysconf(_SC_PAGESIZE);
+        marker = mmap(nullptr, markerSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+        if (marker == MAP_FAILED) {
+            marker = nullptr;
+        }
+        dumpFile = fdopen(fd, "w+");
+
+        JitdumpHeader header;
+        header.magic = kJitdumpMagic;
+        header.version = kJitdumpVersion;
+        header.totalSize = sizeof(header);
+        header.elfMach = elfMachine();
+        header.pad1 = 0;
+        header.pid = getpid();
+        header.timestamp = monotonicNanos();
+        header.flags = 0;
+        fwrite(&header, sizeof(header), 1, dumpFile);
+    }
+}
+
+PerfJITSupport::~PerfJITSupport()
+{
+    if (mapFile != nullptr) {
+        fclose(mapFile);
+    }
+    if (marker != nullptr) {
+        munmap(marker, markerSize);
+    }
+    if (dumpFile != nullptr) {
+        fclose(dumpFile);
+    }
+}
+
+void PerfJITSupport::writeCodeLoad(const std::string& name, uint64_t address, uint64_t size)
+{
+    JitdumpCodeLoad load;
+    load.record.id = kJitCodeLoad;
+    load.record.totalSize = sizeof(load) + name.size() + 1 + size;
+    load.record.timestamp = monotonicNanos();
+    load.pid = getpid();
+    load.tid = syscall(SYS_gettid);
+    load.vma = address;
+    load.codeAddress = address;
+    load.codeSize = size;
+    load.codeIndex = codeIndex++;
+
+    fwrite(&load, sizeof(load), 1, dumpFile);
+    fwrite(name.c_str(), name.size() + 1, 1, dumpFile);
+    fwrite((const void *)(intptr_t)address, size, 1, dumpFile);
+}
+
+/* Harus ditulis sebelum record code load fungsi yang sama. */
+void PerfJITSupport::writeDebugInfo(uint64_t address, const std::vector<PerfLine>& lines)
+{
+    JitdumpDebugInfo info;
+    info.record.id = kJitCodeDebugInfo;
+    info.record.totalSize = sizeof(info);
+    for (const PerfLine& line : lines) {
+        info.record.totalSize += sizeof(uint64_t) + 2 * sizeof(uint32_t) + line.file.size() + 1;
+    }
+    info.record.timestamp = monotonicNanos();
+    info.codeAddress = address;
+    info.entries = lines.size();
+
+    fwrite(&info, sizeof(info), 1, dumpFile);
+    for (const PerfLine& line : lines) {
+        uint32_t discriminator = 0;
+        fwrite(&line.address, sizeof(line.address), 1, dumpFile);
+        fwrite(&line.line, sizeof(line.line), 1, dumpFile);
+        fwrite(&discriminator, sizeof(discriminator), 1, dumpFile);
+        fwrite(line.file.c_str(), line.file.size() + 1, 1, dumpFile);
+    }
+}
+
+void PerfJITSupport::objectLoaded(const ObjectFile& object, const RuntimeDyld::LoadedObjectInfo& info)
+{
+    // salinan object dengan alamat section di memori, untuk simbol dan DWARF
+    OwningBinary<ObjectFile> debugObject = info.getObjectForDebug(object);
+    if (debugObject.getBinary() == nullptr) {
+        return;
+    }
+    const ObjectFile& loaded = *debugObject.getBinary();
+    DWARFContextInMemory dwarf(loaded);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const std::pair<SymbolRef, uint64_t>& symbol : computeSymbolSizes(loaded)) {
+        if (symbol.first.getType() != SymbolRef::ST_Function || symbol.second == 0) {
+            continue;
+        }
+        ErrorOr<StringRef> name = symbol.first.getName();
+        ErrorOr<uint64_t> address = symbol.first.getAddress();
+        if (!name || !address) {
+            continue;
+        }
+
+        if (mapFile != nullptr) {
+            fprintf(mapFile, "%llx %llx %s\n", (unsigned long long)*address,
+                    (unsigned long long)symbol.second, name->str().c_str());
+            fflush(mapFile);
+        }
+
+        if (dumpFile != nullptr) {
+            PendingCode code = { name->str(), *address, symbol.second, std::vector<PerfLine>() };
+            DILineInfoTable table = dwarf.getLineInfoForAddressRange(*address, symbol.second);
+            for (const std::pair<uint64_t, DILineInfo>& entry : table) {
+                PerfLine line = { entry.first, entry.second.Line, entry.second.FileName };
+                code.lines.push_back(line);
+            }
+            pending.push_back(code);
+        }
+    }
+}
+
+void PerfJITSupport::codeFinalized(uint64_t begin, uint64_t end)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (dumpFile == nullptr) {
+        return;
+    }
+
+    std::vector<PendingCode> remaining;
+    for (const PendingCode& code : pending) {
+        if (code.address < begin || code.address >= end) {
+            remaining.push_back(code);
+            continue;
+        }
+        if (!code.lines.empty()) {
+            writeDebugInfo(code.address, code.lines);
+        }
+        writeCodeLoad(code.name, code.address, code.size);
+    }
+    pending.swap(remaining);
+    fflush(dumpFile);
+}
+
+uint8_t *PerfMemoryManager::allocateCodeSection(uintptr_t size, unsigned alignment, unsigned sectionID,
+                                                StringRef sectionName)
+{
+    uint8_t *code = SectionMemoryManager::allocateCodeSection(size, alignment, sectionID, sectionName);
+    if (code != nullptr) {
+        codeSections.push_back(std::make_pair((uint64_t)(uintptr_t)code, (uint64_t)(uintptr_t)code + size));
+    }
+    return code;
+}
+
+bool PerfMemoryManager::finalizeMemory(std::string *errorMessage)
+{
+    // true berarti gagal, sama dengan SectionMemoryManager
+    if (SectionMemoryManager::finalizeMemory(errorMessage)) {
+        return true;
+    }
+    if (perf != nullptr) {
+        for (const std::pair<uint64_t, uint64_t>& section : codeSections) {
+            perf->codeFinalized(section.first, section.second);
+        }
+    }
+    codeSections.clear();
+    return false;
+}
+
+PerfJITSupport *perfSupport(const CompileOptions& opts)
+{
+    static std::unique_ptr<PerfJITSupport> instance;
+    static std::once_flag once;
+
+    if (!opts.perfMap && !opts.perfJitdump) {
+        return nullptr;
+    }
+    std::call_once(once, [&opts]() {
+        instance.reset(new PerfJITSupport(opts.perfMap, opts.perfJitdump));
+    });
+    return instance.get();
+}
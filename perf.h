@@ -0,0 +1,107 @@
+#ifndef BOSOJOWO_PERF_H
+#define BOSOJOWO_PERF_H
+
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <llvm/ExecutionEngine/RuntimeDyld.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/Object/ObjectFile.h>
+
+#include "options.h"
+
+/* Satu baris .jowo di kode hasil JIT, untuk record debug info jitdump. */
+struct PerfLine {
+    uint64_t address;
+    uint32_t line;
+    std::string file;
+};
+
+/**
+ * Daftarkan kode hasil JIT ke `perf` supaya frame-nya tidak `[unknown]`.
+ *
+ * - perf map: `/tmp/perf-PID.map`, satu baris `alamat ukuran nama` per fungsi,
+ *   langsung dibaca `perf report`.
+ * - jitdump: `/tmp/jit-PID.dump` berisi salinan kode setiap fungsi dan, apabila
+ *   ada debug info (-g, -gline-tables-only), tabel baris .jowo-nya. Dipakai lewat
+ *   `perf record -k 1` lalu `perf inject --jit`.
+ *
+ * Dipanggil setiap kali object selesai di-load oleh RuntimeDyld, bisa dari
+ * beberapa thread (--tiered). Saat itu relokasi belum diterapkan, jadi record
+ * jitdump (yang menyalin byte kode) ditunda sampai memorinya di-finalize oleh
+ * PerfMemoryManager.
+ */
+class PerfJITSupport {
+    /* Fungsi yang sudah di-load tapi kodenya belum direlokasi. */
+    struct PendingCode {
+        std::string name;
+        uint64_t address;
+        uint64_t size;
+        std::vector<PerfLine> lines;
+    };
+
+    std::mutex mutex;
+    FILE *mapFile;
+    FILE *dumpFile;
+    void *marker;           // mmap file jitdump supaya tercatat oleh perf record
+    size_t markerSize;
+    uint64_t codeIndex;
+    std::vector<PendingCode> pending;
+
+    void writeCodeLoad(const std::string& name, uint64_t address, uint64_t size);
+    void writeDebugInfo(uint64_t address, const std::vector<PerfLine>& lines);
+
+public:
+    PerfJITSupport(bool perfMap, bool jitdump);
+    ~PerfJITSupport();
+
+    void objectLoaded(const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info);
+
+    /* Kode di [begin, end) sudah direlokasi: tulis record jitdump yang tertunda. */
+    void codeFinalized(uint64_t begin, uint64_t end);
+};
+
+/**
+ * SectionMemoryManager yang memberi tahu PerfJITSupport setelah finalizeMemory,
+ * yaitu setelah RuntimeDyld menerapkan relokasi, sehingga byte kode di jitdump
+ * sama dengan yang dijalankan. `perf` boleh nullptr.
+ */
+class PerfMemoryManager : public llvm::SectionMemoryManager {
+    PerfJITSupport *perf;
+    std::vector<std::pair<uint64_t, uint64_t> > codeSections;   // belum di-finalize
+
+public:
+    explicit PerfMemoryManager(PerfJITSupport *perf) : perf(perf) { }
+
+    uint8_t *allocateCodeSection(uintptr_t size, unsigned alignment, unsigned sectionID,
+                                 llvm::StringRef sectionName) override;
+    bool finalizeMemory(std::string *errorMessage = nullptr) override;
+};
+
+/* Instance untuk proses ini sesuai --perf, nullptr apabila tidak diminta. */
+PerfJITSupport *perfSupport(const CompileOptions& opts);
+
+/**
+ * Callback `NotifyLoaded` untuk ObjectLinkingLayer ORC: teruskan setiap object
+ * yang baru di-load ke PerfJITSupport.
+ */
+struct PerfNotifyLoaded {
+    PerfJITSupport *perf;
+
+    PerfNotifyLoaded(PerfJITSupport *perf = nullptr) : perf(perf) { }
+
+    template <typename HandleT, typename ObjSetT, typename LoadedInfoListT>
+    void operator()(HandleT, const ObjSetT& objects, const LoadedInfoListT& infos) {
+        if (perf == nullptr) {
+            return;
+        }
+        for (size_t i = 0; i < objects.size(); i++) {
+            perf->objectLoaded(*objects[i], *infos[i]);
+        }
+    }
+};
+
+#endif
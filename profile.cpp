@@ -0,0 +1,182 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/ProfileData/InstrProf.h>
+
+#include "codegen.h"
+#include "profile.h"
+
+using namespace llvm;
+
+static bool profiling(CodeGenContext& context)
+{
+    return context.options.profileGenerate || context.profileReader;
+}
+
+/* Hash bentuk fungsi (FNV-1a dari jenis region). */
+static uint64_t shapeHash(const std::string& shape)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : shape) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void beginFunctionProfile(CodeGenContext& context, Function *function)
+{
+    if (!profiling(context)) {
+        return;
+    }
+
+    FunctionProfile profile;
+    profile.function = function;
+    profile.nameVar = nullptr;
+
+    if (context.options.profileGenerate) {
+        // nama variabel diikuti pass InstrProfiling untuk counter dan data profile
+        LLVMContext& ctx = function->getContext();
+        Constant *name = ConstantDataArray::getString(ctx, function->getName(), false);
+        profile.nameVar = new GlobalVariable(*context.module, name->getType(), true,
+                                             GlobalValue::PrivateLinkage, name,
+                                             "__llvm_profile_name_" + function->getName().str());
+    }
+
+    context.profiles.push_back(profile);
+    profileRegion(context, &function->getEntryBlock(), RegionEntry);
+}
+
+unsigned profileRegion(CodeGenContext& context, BasicBlock *block, ProfileRegionKind kind)
+{
+    if (context.profiles.empty()) {
+        return 0;
+    }
+
+    FunctionProfile& profile = context.profiles.back();
+    unsigned index = profile.shape.size();
+    profile.shape.push_back((char)kind);
+
+    if (profile.nameVar != nullptr) {
+        // jumlah counter dan hash belum diketahui, diisi di endFunctionProfile
+        LLVMContext& ctx = block->getContext();
+        Function *increment = Intrinsic::getDeclaration(context.module, Intrinsic::instrprof_increment);
+        Value *args[] = {
+            ConstantExpr::getBitCast(profile.nameVar, Type::getInt8PtrTy(ctx)),
+            ConstantInt::get(Type::getInt64Ty(ctx), 0),
+            ConstantInt::get(Type::getInt32Ty(ctx), 0),
+            ConstantInt::get(Type::getInt32Ty(ctx), index)
+        };
+        profile.increments.push_back(CallInst::Create(increment, args, "", block));
+    }
+    return index;
+}
+
+void profileBranch(CodeGenContext& context, BranchInst *branch, unsigned taken, unsigned other, bool loop)
+{
+    if (context.profiles.empty() || !context.profileReader) {
+        return;
+    }
+    ProfileBranch pb;
+    pb.branch = branch;
+    pb.taken = taken;
+    pb.other = other;
+    pb.loop = loop;
+    context.profiles.back().branches.push_back(pb);
+}
+
+/* Branch weight metadata hanya 32 bit, counter besar diskalakan. */
+static MDNode *branchWeights(LLVMContext& ctx, uint64_t taken, uint64_t other)
+{
+    uint64_t scale = std::max(taken, other) / UINT32_MAX + 1;
+    return MDBuilder(ctx).createBranchWeights((uint32_t)(taken / scale), (uint32_t)(other / scale));
+}
+
+void endFunctionProfile(CodeGenContext& context)
+{
+    if (context.profiles.empty()) {
+        return;
+    }
+
+    FunctionProfile profile = context.profiles.back();
+    context.profiles.pop_back();
+
+    LLVMContext& ctx = profile.function->getContext();
+    uint64_t hash = shapeHash(profile.shape);
+
+    for (CallInst *increment : profile.increments) {
+        increment->setArgOperand(1, ConstantInt::get(Type::getInt64Ty(ctx), hash));
+        increment->setArgOperand(2, ConstantInt::get(Type::getInt32Ty(ctx), profile.shape.size()));
+    }
+
+    if (!context.profileReader) {
+        return;
+    }
+
+    std::vector<uint64_t> counts;
+    std::error_code ec = context.profileReader->getFunctionCounts(profile.function->getName(), hash, counts);
+    if (ec) {
+        if (ec == instrprof_error::hash_mismatch) {
+            std::cerr << "warning: profile for " << profile.function->getName().str()
+                      << " is out of date, ignored" << std::endl;
+            context.profileStale++;
+        }
+        return;
+    }
+    if (counts.size() != profile.shape.size()) {
+        context.profileStale++;
+        return;
+    }
+    context.profileMatched++;
+
+    // region 0 selalu entry fungsi
+    profile.function->setEntryCount(counts[0]);
+
+    for (const ProfileBranch& pb : profile.branches) {
+        uint64_t taken = counts[pb.taken];
+        uint64_t other = counts[pb.other];
+        if (pb.loop) {
+            // body dihitung sekali per iterasi, lompat balik = body - keluar
+            taken = taken > other ? taken - other : 0;
+        }
+        pb.branch->setMetadata(LLVMContext::MD_prof, branchWeights(ctx, taken, other));
+    }
+}
+
+void finishModuleProfile(CodeGenContext& context)
+{
+    if (!context.profileReader) {
+        return;
+    }
+
+    uint64_t maxCount = 0;
+    for (Function& function : *context.module) {
+        Optional<uint64_t> count = function.getEntryCount();
+        if (count.hasValue()) {
+            maxCount = std::max(maxCount, *count);
+        }
+    }
+
+    unsigned cold = 0, hot = 0;
+    for (Function& function : *context.module) {
+        Optional<uint64_t> count = function.getEntryCount();
+        if (!count.hasValue() || function.getName() == "main") {
+            continue;
+        }
+        if (*count == 0) {
+            function.addFnAttr(Attribute::Cold);
+            cold++;
+        }else if (*count * 100 >= maxCount) {
+            // paling tidak 1% dari fungsi terpanas
+            function.addFnAttr(Attribute::InlineHint);
+            hot++;
+        }
+    }
+
+    std::cout << "Profile: " << context.profileMatched << " functions matched, "
+              << context.profileStale << " out of date, " << hot << " hot, " << cold << " cold" << std::endl;
+}
@@ -0,0 +1,57 @@
+#ifndef BOSOJOWO_PROFILE_H
+#define BOSOJOWO_PROFILE_H
+
+#include <string>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+
+class CodeGenContext;
+
+/* Jenis region yang punya counter, urutannya menjadi hash fungsi. */
+enum ProfileRegionKind {
+    RegionEntry = 'F',      // entry fungsi
+    RegionThen = 'T',       // arm `nek ... njuk`
+    RegionElse = 'E',       // arm `nek ora`
+    RegionLoopBody = 'L',   // body `muter`
+    RegionLoopExit = 'X'    // setelah `muter` selesai
+};
+
+/* Cabang yang diberi branch weight setelah counter dari profile diketahui. */
+struct ProfileBranch {
+    llvm::BranchInst *branch;
+    unsigned taken;     // region tujuan pertama (then / body loop)
+    unsigned other;     // region tujuan kedua (else / keluar loop)
+    bool loop;          // counter body loop termasuk iterasi pertama
+};
+
+/* Status profile untuk fungsi yang sedang di-generate. */
+struct FunctionProfile {
+    llvm::Function *function;
+    llvm::GlobalVariable *nameVar;          // __llvm_profile_name_<fungsi>, hanya --profile-generate
+    std::string shape;                      // jenis setiap region
+    std::vector<llvm::CallInst*> increments;
+    std::vector<ProfileBranch> branches;
+};
+
+/**
+ * PGO di frontend, mengikuti cara clang.
+ *
+ * --profile-generate menaruh llvm.instrprof.increment di awal setiap region;
+ * pass InstrProfiling menurunkannya menjadi counter global dan runtime profile
+ * menulis .profraw saat program exit. --profile-use membaca counter yang sama
+ * dari .profdata (hasil `llvm-profdata merge`), lalu memasang branch weight di
+ * `nek`/`muter` dan entry count di fungsi. Jumlah dan jenis region dijadikan
+ * hash, profile dari source yang sudah berubah diabaikan.
+ */
+void beginFunctionProfile(CodeGenContext& context, llvm::Function *function);
+unsigned profileRegion(CodeGenContext& context, llvm::BasicBlock *block, ProfileRegionKind kind);
+void profileBranch(CodeGenContext& context, llvm::BranchInst *branch, unsigned taken, unsigned other, bool loop);
+void endFunctionProfile(CodeGenContext& context);
+
+/* Setelah semua fungsi di-generate: fungsi yang tidak pernah dipanggil jadi cold, yang panas diberi inlinehint. */
+void finishModuleProfile(CodeGenContext& context);
+
+#endif
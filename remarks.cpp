@@ -0,0 +1,215 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include <llvm/IR/DiagnosticPrinter.h>
+#include <llvm/IR/Function.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "remarks.h"
+
+using namespace llvm;
+
+RemarkCollector::RemarkCollector(const CompileOptions& opts) : opts(opts), allPasses(false)
+{
+    std::stringstream list(opts.remarksPasses);
+    std::string pass;
+    while (std::getline(list, pass, ',')) {
+        if (pass == "all") {
+            allPasses = true;
+        }else if (!pass.empty()) {
+            passes.insert(pass);
+        }
+    }
+}
+
+void RemarkCollector::install(LLVMContext& ctx)
+{
+    // RespectFilters = false: semua remark sampai ke handler tanpa -pass-remarks
+    ctx.setDiagnosticHandler(handleDiagnostic, this, false);
+}
+
+void RemarkCollector::handleDiagnostic(const DiagnosticInfo& info, void *collector)
+{
+    RemarkCollector *self = static_cast<RemarkCollector*>(collector);
+
+    switch (info.getKind()) {
+        case DK_OptimizationRemark:
+            self->add(cast<DiagnosticInfoOptimizationBase>(info), "Passed");
+            return;
+        case DK_OptimizationRemarkMissed:
+            self->add(cast<DiagnosticInfoOptimizationBase>(info), "Missed");
+            return;
+        case DK_OptimizationRemarkAnalysis:
+            self->add(cast<DiagnosticInfoOptimizationBase>(info), "Analysis");
+            return;
+        case DK_OptimizationFailure:
+            self->add(cast<DiagnosticInfoOptimizationBase>(info), "Failure");
+            return;
+        default:
+            break;
+    }
+
+    // diagnostic lain dicetak seperti handler bawaan LLVMContext
+    std::string text;
+    raw_string_ostream out(text);
+    DiagnosticPrinterRawOStream printer(out);
+    info.print(printer);
+    out.flush();
+
+    const char *severity = "note";
+    if (info.getSeverity() == DS_Error) {
+        severity = "error";
+    }else if (info.getSeverity() == DS_Warning) {
+        severity = "warning";
+    }
+    std::cerr << severity << ": " << text << std::endl;
+    if (info.getSeverity() == DS_Error) {
+        exit(1);
+    }
+}
+
+void RemarkCollector::add(const DiagnosticInfoOptimizationBase& info, const char *kind)
+{
+    if (!allPasses && passes.find(info.getPassName()) == passes.end()) {
+        return;
+    }
+
+    Remark remark;
+    remark.kind = kind;
+    remark.pass = info.getPassName();
+    remark.function = info.getFunction().getName();
+    remark.file = "<unknown>";
+    remark.line = 0;
+    remark.column = 0;
+    remark.message = info.getMsg().str();
+
+    if (info.isLocationAvailable()) {
+        StringRef file;
+        info.getLocation(&file, &remark.line, &remark.column);
+        remark.file = file;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    remarks.push_back(remark);
+}
+
+/* String dengan kutip tunggal YAML. */
+static std::string yamlQuote(const std::string& text)
+{
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\'') {
+            quoted += "''";
+        }else{
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+static std::string jsonQuote(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                // karakter kontrol lain tidak boleh mentah di string JSON
+                if ((unsigned char)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+                    quoted += escaped;
+                }else{
+                    quoted += c;
+                }
+                break;
+        }
+    }
+    return quoted + "\"";
+}
+
+static void writeText(raw_ostream& out, const std::vector<Remark>& remarks)
+{
+    for (const Remark& r : remarks) {
+        out << r.file << ":" << r.line << ":" << r.column << ": remark: ";
+        if (r.kind != "Passed") {
+            out << "[" << r.kind << "] ";
+        }
+        out << r.message << " [" << r.pass << ", " << r.function << "]\n";
+    }
+}
+
+static void writeYAML(raw_ostream& out, const std::vector<Remark>& remarks)
+{
+    for (const Remark& r : remarks) {
+        out << "--- !" << r.kind << "\n"
+            << "Pass:            " << r.pass << "\n"
+            << "Function:        " << yamlQuote(r.function) << "\n"
+            << "DebugLoc:        { File: " << yamlQuote(r.file) << ", Line: " << r.line
+            << ", Column: " << r.column << " }\n"
+            << "Message:         " << yamlQuote(r.message) << "\n"
+            << "...\n";
+    }
+}
+
+static void writeJSON(raw_ostream& out, const std::vector<Remark>& remarks)
+{
+    out << "[\n";
+    for (size_t i = 0; i < remarks.size(); i++) {
+        const Remark& r = remarks[i];
+        out << "  {\"kind\": " << jsonQuote(r.kind)
+            << ", \"pass\": " << jsonQuote(r.pass)
+            << ", \"function\": " << jsonQuote(r.function)
+            << ", \"file\": " << jsonQuote(r.file)
+            << ", \"line\": " << r.line
+            << ", \"column\": " << r.column
+            << ", \"message\": " << jsonQuote(r.message) << "}"
+            << (i + 1 < remarks.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+bool RemarkCollector::write()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::stable_sort(remarks.begin(), remarks.end(), [](const Remark& a, const Remark& b) {
+        if (a.file != b.file) {
+            return a.file < b.file;
+        }
+        return a.line < b.line;
+    });
+
+    std::error_code ec;
+    std::unique_ptr<raw_fd_ostream> file;
+    if (!opts.remarksPath.empty()) {
+        file.reset(new raw_fd_ostream(opts.remarksPath, ec, sys::fs::F_Text));
+        if (ec) {
+            std::cerr << "error: cannot open " << opts.remarksPath << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+    // yaml/json selalu punya file (lihat parseOptions), text ke stderr
+    raw_ostream& out = file ? *file : errs();
+
+    switch (opts.remarksFormat) {
+        case RemarkYAML:
+            writeYAML(out, remarks);
+            break;
+        case RemarkJSON:
+            writeJSON(out, remarks);
+            break;
+        default:
+            writeText(out, remarks);
+            break;
+    }
+    out.flush();
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef BOSOJOWO_REMARKS_H
+#define BOSOJOWO_REMARKS_H
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include "options.h"
+
+/* Satu remark optimasi beserta lokasinya di file .jowo. */
+struct Remark {
+    std::string kind;       // Passed, Missed, Analysis, Failure
+    std::string pass;
+    std::string function;
+    std::string file;
+    unsigned line;
+    unsigned column;
+    std::string message;
+};
+
+/**
+ * --remarks: kumpulkan remark optimasi dari LLVM lewat diagnostic handler.
+ *
+ * Lokasi remark diambil dari debug location instruksi (line table dari
+ * frontend), jadi menunjuk ke baris di file .jowo. Hanya pass di
+ * --remarks-passes yang dicatat. Diagnostic lain (warning/error backend)
+ * tetap dicetak seperti handler bawaan. Handler boleh dipasang di beberapa
+ * LLVMContext sekaligus (ThinLTO), pencatatan dilindungi mutex.
+ */
+class RemarkCollector {
+    const CompileOptions& opts;
+    std::set<std::string> passes;
+    bool allPasses;
+    std::mutex lock;
+    std::vector<Remark> remarks;
+
+    static void handleDiagnostic(const llvm::DiagnosticInfo& info, void *collector);
+    void add(const llvm::DiagnosticInfoOptimizationBase& info, const char *kind);
+
+public:
+    explicit RemarkCollector(const CompileOptions& opts);
+
+    void install(llvm::LLVMContext& ctx);
+
+    /* Tulis semua remark, urut per file dan baris, sesuai --remarks=FORMAT. */
+    bool write();
+};
+
+#endif
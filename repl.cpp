@@ -0,0 +1,263 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "node.h"
+#include "codegen.h"
+#include "jit.h"
+#include "optimize.h"
+#include "repl.h"
+#include "silence.h"
+#include "stringutil.h"
+
+extern NBlock* programBlock;
+extern int yydebug;
+extern int yyparse();
+
+// buffer input flex untuk parse dari string
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE yy_scan_string(const char *str);
+extern void yy_delete_buffer(YY_BUFFER_STATE buffer);
+
+/* Prototipe fungsi dari entri sebelumnya. */
+struct ReplFunction {
+    FunctionType *type;
+    bool isPure;
+};
+
+/* Variabel top level dari entri sebelumnya, disimpan sebagai global. */
+struct ReplVariable {
+    Type *type;
+    NVariableDeclaration *decl;     // AST entri asalnya tidak pernah dihapus
+};
+
+/**
+ * Selisih `mulai`/`{` dan `bar`/`}` di satu baris, di luar string literal.
+ * Entri baru dijalankan setelah semua block-nya ditutup.
+ */
+static int blockDepth(const std::string& line)
+{
+    int depth = 0;
+    bool inString = false;
+    std::string word;
+
+    for (size_t i = 0; i <= line.size(); i++) {
+        char c = i < line.size() ? line[i] : ' ';
+        if (inString) {
+            if (c == '\\') {
+                i++;
+            }else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+        if (isalnum((unsigned char)c) || c == '_') {
+            word += c;
+            continue;
+        }
+        if (word == "mulai") {
+            depth++;
+        }else if (word == "bar") {
+            depth--;
+        }
+        word.clear();
+
+        if (c == '"') {
+            inString = true;
+        }else if (c == '{') {
+            depth++;
+        }else if (c == '}') {
+            depth--;
+        }
+    }
+    return depth;
+}
+
+class Repl {
+    TargetMachine& tm;
+    CompileOptions options;
+    JowoJIT jit;
+    std::map<std::string, ReplFunction> functions;
+    std::map<std::string, ReplVariable> variables;
+    unsigned entries;
+
+    bool checkRedefinition(NBlock& root);
+    void declareKnown(CodeGenContext& context);
+    void evaluate(NBlock& root);
+
+public:
+    Repl(TargetMachine& tm, const CompileOptions& opts) :
+        tm(tm), options(opts), jit(tm, perfSupport(opts)), entries(0) {
+        options.run = true;             // tanpa cetak IR
+        options.wholeProgram = false;   // entri berikutnya masih butuh simbolnya
+    }
+
+    void parseAndEvaluate(const std::string& source);
+};
+
+/* Simbol yang sudah ada di JIT tidak bisa didefinisikan ulang. */
+bool Repl::checkRedefinition(NBlock& root)
+{
+    bool ok = true;
+    for (NStatement *stmt : root.statements) {
+        std::string name;
+        if (NFunctionDeclaration *decl = dynamic_cast<NFunctionDeclaration*>(stmt)) {
+            name = decl->id.name;
+        }else if (NExternDeclaration *decl = dynamic_cast<NExternDeclaration*>(stmt)) {
+            name = decl->id.name;
+        }else if (NVariableDeclaration *decl = dynamic_cast<NVariableDeclaration*>(stmt)) {
+            if (variables.count(decl->id.name)) {
+                std::cerr << "error: variable " << decl->id.name << " is already declared, assign it with "
+                          << decl->id.name << " = ..." << std::endl;
+                ok = false;
+            }
+            continue;
+        }else{
+            continue;
+        }
+        if (functions.count(name)) {
+            std::cerr << "error: function " << name << " is already defined in this session" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/* Deklarasikan semua yang sudah di-JIT supaya bisa dipakai entri baru. */
+void Repl::declareKnown(CodeGenContext& context)
+{
+    for (const std::pair<const std::string, ReplFunction>& function : functions) {
+        Function::Create(function.second.type, GlobalValue::ExternalLinkage, function.first, context.module);
+        if (function.second.isPure) {
+            context.pureFunctions.insert(function.first);
+        }
+    }
+    for (const std::pair<const std::string, ReplVariable>& variable : variables) {
+        GlobalVariable *global = new GlobalVariable(*context.module, variable.second.type, false,
+                                                    GlobalValue::ExternalLinkage, nullptr, variable.first);
+        context.inheritedLocals[variable.first] = global;
+        context.inheritedVarDecls[variable.first] = variable.second.decl;
+    }
+}
+
+void Repl::evaluate(NBlock& root)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (!checkRedefinition(root)) {
+        return;
+    }
+
+    // pesan codegen, optimasi dan JIT ke std::cout bukan untuk pengguna repl,
+    // dibungkam sampai entri siap dijalankan
+    SilenceStdout silence;
+    CodeGenContext context(options, &tm);
+    declareKnown(context);
+    context.generateCode(root);
+
+    std::unique_ptr<Module> module(context.module);
+    context.module = nullptr;
+    if (context.errorCount > 0) {
+        return;
+    }
+
+    // setiap entri punya `main` sendiri
+    std::string entryName = "repl." + std::to_string(++entries);
+    module->getFunction("main")->setName(entryName);
+
+    if (!optimizeModule(*module, tm, options, true)) {
+        return;
+    }
+
+    // yang didefinisikan entri ini, didaftarkan setelah berhasil di-JIT
+    std::map<std::string, ReplFunction> newFunctions;
+    std::map<std::string, ReplVariable> newVariables;
+    for (NStatement *stmt : root.statements) {
+        if (NFunctionDeclaration *decl = dynamic_cast<NFunctionDeclaration*>(stmt)) {
+            ReplFunction function = { module->getFunction(decl->id.name)->getFunctionType(), decl->isPure };
+            newFunctions[decl->id.name] = function;
+        }else if (NExternDeclaration *decl = dynamic_cast<NExternDeclaration*>(stmt)) {
+            ReplFunction function = { module->getFunction(decl->id.name)->getFunctionType(), decl->isPure };
+            newFunctions[decl->id.name] = function;
+        }else if (NVariableDeclaration *decl = dynamic_cast<NVariableDeclaration*>(stmt)) {
+            GlobalVariable *global = module->getGlobalVariable(decl->id.name);
+            if (global != nullptr) {
+                ReplVariable variable = { global->getType()->getElementType(), decl };
+                newVariables[decl->id.name] = variable;
+            }
+        }
+    }
+
+    jit.addModule(std::move(module));
+    uint64_t address = jit.getAddress(entryName);
+    if (address == 0) {
+        std::cerr << "error: JIT failed" << std::endl;
+        return;
+    }
+    functions.insert(newFunctions.begin(), newFunctions.end());
+    variables.insert(newVariables.begin(), newVariables.end());
+
+    if (options.timePhases) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "[time] compile: " << ms << " ms" << std::endl;
+    }
+
+    silence.restore();
+
+    void (*entry)() = (void (*)())(intptr_t)address;
+    entry();
+    fflush(stdout);
+}
+
+void Repl::parseAndEvaluate(const std::string& source)
+{
+    programBlock = nullptr;
+    YY_BUFFER_STATE buffer = yy_scan_string(source.c_str());
+    int failed = yyparse();
+    yy_delete_buffer(buffer);
+
+    if (failed == 0 && programBlock != nullptr) {
+        evaluate(*programBlock);
+    }
+}
+
+int runRepl(TargetMachine& tm, const CompileOptions& opts)
+{
+    yydebug = 0;
+    Repl repl(tm, opts);
+
+    std::cout << "bosojowo repl, `:metu` untuk keluar" << std::endl;
+
+    std::string source;
+    std::string line;
+    int depth = 0;
+    for (;;) {
+        std::cout << (source.empty() ? "jowo> " : "  ... ") << std::flush;
+        if (!std::getline(std::cin, line)) {
+            break;
+        }
+        if (source.empty()) {
+            std::string command = trim(line);
+            if (command.empty()) {
+                continue;
+            }
+            if (command == ":metu" || command == ":q") {
+                break;
+            }
+        }
+
+        source += line + "\n";
+        depth += blockDepth(line);
+        if (depth > 0) {
+            continue;
+        }
+
+        repl.parseAndEvaluate(source);
+        source.clear();
+        depth = 0;
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,19 @@
+#ifndef BOSOJOWO_REPL_H
+#define BOSOJOWO_REPL_H
+
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+/**
+ * `bosojowo repl`: baca statement atau `fungsi` dari stdin lalu jalankan.
+ *
+ * Setiap entri di-parse, di-generate menjadi module sendiri dan ditambahkan ke
+ * satu sesi JIT ORC yang hidup selama repl. Fungsi dan variabel top level dari
+ * entri sebelumnya cukup dideklarasikan (prototipe / global external) di module
+ * baru dan di-link oleh JIT ke kode yang sudah ada, jadi tidak pernah di-compile
+ * ulang. Mengembalikan exit status.
+ */
+int runRepl(llvm::TargetMachine& tm, const CompileOptions& opts);
+
+#endif
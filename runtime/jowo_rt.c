@@ -0,0 +1,564 @@
+/*
+ * Runtime kecil untuk executable jowo yang di-link tanpa libc.
+ *
+ * Menyediakan entry point `_start`, `exit`, `puts`, `putchar`, `printf` dan
+ * fungsi memori yang boleh dipanggil oleh kode hasil LLVM. Khusus Linux
+ * x86-64, langsung memakai syscall.
+ *
+ * Mulai -O1 LLVM mengganti printf("x") dan printf("\n") dengan putchar, dan
+ * printf("...\n") dengan puts. fputs/fwrite hanya muncul dari fprintf/fputs
+ * ke FILE*, yang tidak bisa dipanggil dari jowo, jadi tidak disediakan.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+
+#define SYS_write       1
+#define SYS_exit_group  231
+
+static long jowo_syscall3(long n, long a, long b, long c)
+{
+    long ret;
+    __asm__ volatile ("syscall"
+                      : "=a"(ret)
+                      : "a"(n), "D"(a), "S"(b), "d"(c)
+                      : "rcx", "r11", "memory");
+    return ret;
+}
+
+/* -- output stdout, di-buffer per baris -- */
+
+static char out_buf[4096];
+static size_t out_len;
+
+static void flush_out(void)
+{
+    size_t off = 0;
+    while (off < out_len) {
+        long n = jowo_syscall3(SYS_write, 1, (long)(out_buf + off), (long)(out_len - off));
+        if (n <= 0) {
+            break;
+        }
+        off += (size_t)n;
+    }
+    out_len = 0;
+}
+
+static void put_char(char c)
+{
+    if (out_len == sizeof(out_buf)) {
+        flush_out();
+    }
+    out_buf[out_len++] = c;
+    if (c == '\n') {
+        flush_out();
+    }
+}
+
+static void put_pad(char c, int count)
+{
+    while (count-- > 0) {
+        put_char(c);
+    }
+}
+
+static size_t str_len(const char *s)
+{
+    size_t n = 0;
+    while (s[n]) {
+        n++;
+    }
+    return n;
+}
+
+/* -- format angka -- */
+
+struct spec {
+    int left;       /* '-' */
+    int zero;       /* '0' */
+    int plus;       /* '+' */
+    int space;      /* ' ' */
+    int width;
+    int precision;  /* -1 apabila tidak ada */
+};
+
+/* tulis digit ke `buf` dari belakang, kembalikan pointer ke digit pertama */
+static char *format_uint(char *end, unsigned long long value, unsigned base, int upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char *p = end;
+    do {
+        *--p = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    return p;
+}
+
+/* padding kiri + tanda, body sepanjang `len` ditulis pemanggil lalu field_end */
+static void field_begin(const struct spec *sp, const char *sign, size_t len)
+{
+    int total = (int)(str_len(sign) + len);
+    int pad = sp->width > total ? sp->width - total : 0;
+
+    if (!sp->left && !sp->zero) {
+        put_pad(' ', pad);
+    }
+    while (*sign) {
+        put_char(*sign++);
+    }
+    if (!sp->left && sp->zero) {
+        put_pad('0', pad);
+    }
+}
+
+static void field_end(const struct spec *sp, const char *sign, size_t len)
+{
+    int total = (int)(str_len(sign) + len);
+    if (sp->left && sp->width > total) {
+        put_pad(' ', sp->width - total);
+    }
+}
+
+static void put_field(const struct spec *sp, const char *sign, const char *body, size_t len)
+{
+    field_begin(sp, sign, len);
+    for (size_t i = 0; i < len; i++) {
+        put_char(body[i]);
+    }
+    field_end(sp, sign, len);
+}
+
+static const char *sign_of(const struct spec *sp, int negative)
+{
+    if (negative) {
+        return "-";
+    }
+    return sp->plus ? "+" : (sp->space ? " " : "");
+}
+
+static void put_int(const struct spec *sp, long long value)
+{
+    char buf[32];
+    int negative = value < 0;
+    unsigned long long mag = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    char *p = format_uint(buf + sizeof(buf), mag, 10, 0);
+    put_field(sp, sign_of(sp, negative), p, (size_t)(buf + sizeof(buf) - p));
+}
+
+/*
+ * -- double --
+ *
+ * Nilai double = m * 2^e ditulis persis sebagai digit desimal (bilangan besar
+ * basis 10^9), lalu dibulatkan half-even di digit yang diminta, sama seperti
+ * glibc. Untuk e < 0, m * 2^e = m * 5^-e / 10^-e.
+ */
+
+#define BIG_LIMBS   100             /* m * 5^1074 < 10^770 */
+#define BIG_BASE    1000000000u
+
+struct decimal {
+    char d[BIG_LIMBS * 9];  /* digit penting, tanpa nol di depan dan belakang */
+    int n;                  /* jumlah digit, 0 untuk nol */
+    int dexp;               /* jumlah digit sebelum titik (bisa negatif) */
+};
+
+static void big_mul(unsigned *limbs, int *count, unsigned factor)
+{
+    unsigned long long carry = 0;
+    for (int i = 0; i < *count; i++) {
+        unsigned long long v = (unsigned long long)limbs[i] * factor + carry;
+        limbs[i] = (unsigned)(v % BIG_BASE);
+        carry = v / BIG_BASE;
+    }
+    while (carry != 0) {
+        limbs[(*count)++] = (unsigned)(carry % BIG_BASE);
+        carry /= BIG_BASE;
+    }
+}
+
+/* `value` harus finite dan tidak negatif */
+static void to_decimal(struct decimal *x, double value)
+{
+    union { double d; unsigned long long u; } bits = { value };
+    unsigned long long m = bits.u & ((1ULL << 52) - 1);
+    int biased = (int)((bits.u >> 52) & 0x7ff);
+    int e;
+
+    if (biased == 0) {
+        e = -1074;
+    }else{
+        m |= 1ULL << 52;
+        e = biased - 1075;
+    }
+    x->n = 0;
+    x->dexp = 0;
+    if (m == 0) {
+        return;
+    }
+
+    unsigned limbs[BIG_LIMBS];
+    int count = 0;
+    while (m != 0) {
+        limbs[count++] = (unsigned)(m % BIG_BASE);
+        m /= BIG_BASE;
+    }
+    int pos;
+    for (pos = e; pos >= 29; pos -= 29) {
+        big_mul(limbs, &count, 1u << 29);
+    }
+    if (pos > 0) {
+        big_mul(limbs, &count, 1u << pos);
+    }
+    for (pos = -e; pos >= 13; pos -= 13) {
+        big_mul(limbs, &count, 1220703125u);   /* 5^13 */
+    }
+    for (; pos > 0; pos--) {
+        big_mul(limbs, &count, 5);
+    }
+
+    char *end = format_uint(x->d + sizeof(x->d), limbs[count - 1], 10, 0);
+    int top = (int)(x->d + sizeof(x->d) - end);
+    for (int i = 0; i < top; i++) {
+        x->d[i] = end[i];
+    }
+    x->n = top;
+    for (int i = count - 2; i >= 0; i--) {
+        unsigned limb = limbs[i];
+        for (int j = 8; j >= 0; j--) {
+            x->d[x->n + j] = (char)('0' + limb % 10);
+            limb /= 10;
+        }
+        x->n += 9;
+    }
+    x->dexp = x->n + (e < 0 ? e : 0);
+    while (x->d[x->n - 1] == '0') {
+        x->n--;
+    }
+}
+
+static char decimal_digit(const struct decimal *x, int i)
+{
+    return i >= 0 && i < x->n ? x->d[i] : '0';
+}
+
+/* sisakan `keep` digit penting pertama, pembulatan half-even */
+static void decimal_round(struct decimal *x, int keep)
+{
+    if (keep >= x->n) {
+        return;
+    }
+    if (keep < 0) {
+        x->n = 0;
+        return;
+    }
+
+    int up = x->d[keep] > '5' || (x->d[keep] == '5' && keep + 1 < x->n);
+    if (x->d[keep] == '5' && keep + 1 == x->n) {
+        up = keep > 0 && (x->d[keep - 1] - '0') % 2 == 1;
+    }
+    x->n = keep;
+    if (up) {
+        while (x->n > 0 && x->d[x->n - 1] == '9') {
+            x->n--;
+        }
+        if (x->n == 0) {
+            x->d[0] = '1';
+            x->n = 1;
+            x->dexp++;
+        }else{
+            x->d[x->n - 1]++;
+        }
+    }
+    while (x->n > 0 && x->d[x->n - 1] == '0') {
+        x->n--;
+    }
+}
+
+/* %f, atau %g tanpa nol di belakang apabila `strip` */
+static void put_fixed(const struct spec *sp, const char *sign, const struct decimal *x,
+                      int precision, int strip)
+{
+    int whole = x->dexp > 0 ? x->dexp : 1;
+    int frac = precision;
+    while (strip && frac > 0 && decimal_digit(x, x->dexp + frac - 1) == '0') {
+        frac--;
+    }
+    size_t len = (size_t)whole + (frac > 0 ? 1 + (size_t)frac : 0);
+
+    field_begin(sp, sign, len);
+    for (int i = 0; i < whole; i++) {
+        put_char(x->dexp > 0 ? decimal_digit(x, i) : '0');
+    }
+    if (frac > 0) {
+        put_char('.');
+        for (int i = 0; i < frac; i++) {
+            put_char(decimal_digit(x, x->dexp + i));
+        }
+    }
+    field_end(sp, sign, len);
+}
+
+/* %e, atau %g tanpa nol di belakang apabila `strip` */
+static void put_exponent(const struct spec *sp, const char *sign, const struct decimal *x,
+                         int precision, int strip, int upper)
+{
+    int exponent = x->n > 0 ? x->dexp - 1 : 0;
+    int frac = precision;
+    while (strip && frac > 0 && decimal_digit(x, frac) == '0') {
+        frac--;
+    }
+    char ebuf[8];
+    char *eend = ebuf + sizeof(ebuf);
+    char *e = format_uint(eend, (unsigned long long)(exponent < 0 ? -exponent : exponent), 10, 0);
+    if (eend - e < 2) {
+        *--e = '0';
+    }
+    *--e = exponent < 0 ? '-' : '+';
+    *--e = upper ? 'E' : 'e';
+    size_t len = 1 + (frac > 0 ? 1 + (size_t)frac : 0) + (size_t)(eend - e);
+
+    field_begin(sp, sign, len);
+    put_char(decimal_digit(x, 0));
+    if (frac > 0) {
+        put_char('.');
+        for (int i = 1; i <= frac; i++) {
+            put_char(decimal_digit(x, i));
+        }
+    }
+    while (e < eend) {
+        put_char(*e++);
+    }
+    field_end(sp, sign, len);
+}
+
+static void put_double(const struct spec *sp, double value, char conv)
+{
+    union { double d; unsigned long long u; } bits = { value };
+    int negative = (int)(bits.u >> 63);
+    int upper = conv == 'F' || conv == 'E' || conv == 'G';
+    int precision = sp->precision < 0 ? 6 : sp->precision;
+
+    if (negative) {
+        value = -value;
+    }
+    if (value != value || value > 1.7976931348623157e308) {
+        struct spec plain = *sp;
+        plain.zero = 0;
+        const char *text = value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+        put_field(&plain, sign_of(sp, negative), text, 3);
+        return;
+    }
+
+    struct decimal x;
+    to_decimal(&x, value);
+    const char *sign = sign_of(sp, negative);
+
+    if (conv == 'f' || conv == 'F') {
+        decimal_round(&x, x.dexp + precision);
+        put_fixed(sp, sign, &x, precision, 0);
+    }else if (conv == 'e' || conv == 'E') {
+        decimal_round(&x, precision + 1);
+        put_exponent(sp, sign, &x, precision, 0, upper);
+    }else{
+        /* %g: gaya %f apabila eksponen hasil pembulatan di [-4, precision) */
+        if (precision == 0) {
+            precision = 1;
+        }
+        decimal_round(&x, precision);
+        int exponent = x.n > 0 ? x.dexp - 1 : 0;
+        if (exponent >= -4 && exponent < precision) {
+            put_fixed(sp, sign, &x, precision - 1 - exponent, 1);
+        }else{
+            put_exponent(sp, sign, &x, precision - 1, 1, upper);
+        }
+    }
+}
+
+/* -- API libc yang dipakai kode jowo -- */
+
+int puts(const char *s)
+{
+    while (*s) {
+        put_char(*s++);
+    }
+    put_char('\n');
+    return 0;
+}
+
+int putchar(int c)
+{
+    put_char((char)c);
+    return (unsigned char)c;
+}
+
+int printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+
+    for (const char *f = fmt; *f; f++) {
+        if (*f != '%') {
+            put_char(*f);
+            continue;
+        }
+        f++;
+
+        struct spec sp = { 0, 0, 0, 0, 0, -1 };
+        for (;; f++) {
+            if (*f == '-') sp.left = 1;
+            else if (*f == '0') sp.zero = 1;
+            else if (*f == '+') sp.plus = 1;
+            else if (*f == ' ') sp.space = 1;
+            else break;
+        }
+        if (*f == '*') {
+            sp.width = va_arg(ap, int);
+            f++;
+        }
+        while (*f >= '0' && *f <= '9') {
+            sp.width = sp.width * 10 + (*f++ - '0');
+        }
+        if (*f == '.') {
+            f++;
+            sp.precision = 0;
+            if (*f == '*') {
+                sp.precision = va_arg(ap, int);
+                f++;
+            }
+            while (*f >= '0' && *f <= '9') {
+                sp.precision = sp.precision * 10 + (*f++ - '0');
+            }
+            if (sp.precision < 0) {
+                sp.precision = -1;
+            }
+        }
+
+        int longs = 0;
+        while (*f == 'l' || *f == 'h' || *f == 'z') {
+            if (*f == 'l' || *f == 'z') {
+                longs++;
+            }
+            f++;
+        }
+
+        char buf[32];
+        char *p;
+        switch (*f) {
+            case 'd':
+            case 'i':
+                put_int(&sp, longs ? va_arg(ap, long long) : va_arg(ap, int));
+                break;
+            case 'u':
+            case 'x':
+            case 'X': {
+                unsigned long long v = longs ? va_arg(ap, unsigned long long) : va_arg(ap, unsigned int);
+                p = format_uint(buf + sizeof(buf), v, *f == 'u' ? 10 : 16, *f == 'X');
+                put_field(&sp, "", p, (size_t)(buf + sizeof(buf) - p));
+                break;
+            }
+            case 'p': {
+                p = format_uint(buf + sizeof(buf), (unsigned long long)(size_t)va_arg(ap, void *), 16, 0);
+                put_field(&sp, "0x", p, (size_t)(buf + sizeof(buf) - p));
+                break;
+            }
+            case 'c':
+                buf[0] = (char)va_arg(ap, int);
+                put_field(&sp, "", buf, 1);
+                break;
+            case 's': {
+                const char *s = va_arg(ap, const char *);
+                if (s == NULL) {
+                    s = "(null)";
+                }
+                size_t len = str_len(s);
+                if (sp.precision >= 0 && (size_t)sp.precision < len) {
+                    len = (size_t)sp.precision;
+                }
+                sp.zero = 0;
+                put_field(&sp, "", s, len);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+                put_double(&sp, va_arg(ap, double), *f);
+                break;
+            case '%':
+                put_char('%');
+                break;
+            case '\0':
+                f--;
+                break;
+            default:
+                put_char('%');
+                put_char(*f);
+                break;
+        }
+    }
+
+    va_end(ap);
+    return 0;
+}
+
+void exit(int code)
+{
+    flush_out();
+    jowo_syscall3(SYS_exit_group, code, 0, 0);
+    for (;;) {
+    }
+}
+
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+void *memmove(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    if (d < s) {
+        while (n--) {
+            *d++ = *s++;
+        }
+    }else{
+        while (n--) {
+            d[n] = s[n];
+        }
+    }
+    return dst;
+}
+
+void *memset(void *dst, int c, size_t n)
+{
+    unsigned char *d = dst;
+    while (n--) {
+        *d++ = (unsigned char)c;
+    }
+    return dst;
+}
+
+/* -- entry point -- */
+
+extern void jowo_main(void) __asm__("main");
+
+void jowo_start(void)
+{
+    jowo_main();
+    exit(0);
+}
+
+__asm__(".text\n"
+        ".global _start\n"
+        "_start:\n"
+        "    xor %ebp, %ebp\n"
+        "    and $-16, %rsp\n"
+        "    call jowo_start\n"
+        "    hlt\n");
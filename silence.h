@@ -0,0 +1,27 @@
+#ifndef BOSOJOWO_SILENCE_H
+#define BOSOJOWO_SILENCE_H
+
+#include <iostream>
+
+/**
+ * Bungkam std::cout selama objek ini hidup atau sampai restore().
+ * Dipakai ketika bosojowo menjalankan program pengguna: pesan codegen dan
+ * optimasi tidak boleh tercampur dengan stdout program. Program sendiri
+ * menulis lewat printf, tidak ikut terbungkam.
+ */
+class SilenceStdout {
+    std::streambuf *saved;
+public:
+    explicit SilenceStdout(bool active = true) : saved(active ? std::cout.rdbuf(nullptr) : nullptr) {}
+    ~SilenceStdout() { restore(); }
+
+    void restore() {
+        if (saved != nullptr) {
+            std::cout.rdbuf(saved);
+            std::cout.clear();
+            saved = nullptr;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <algorithm>
+
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "sizereport.h"
+
+using namespace llvm;
+using namespace llvm::object;
+
+struct FunctionSize {
+    std::string name;
+    std::string section;
+    uint64_t size;
+};
+
+static bool collectSizes(const std::string& path, std::vector<FunctionSize>& sizes)
+{
+    ErrorOr<OwningBinary<ObjectFile> > object = ObjectFile::createObjectFile(path);
+    if (!object) {
+        std::cerr << "error: cannot read " << path << ": " << object.getError().message() << std::endl;
+        return false;
+    }
+
+    for (const std::pair<SymbolRef, uint64_t>& symbol : computeSymbolSizes(*object->getBinary())) {
+        if (symbol.first.getType() != SymbolRef::ST_Function) {
+            continue;
+        }
+        ErrorOr<StringRef> name = symbol.first.getName();
+        if (!name) {
+            continue;
+        }
+
+        FunctionSize entry;
+        entry.name = *name;
+        entry.size = symbol.second;
+
+        section_iterator section = object->getBinary()->section_end();
+        StringRef sectionName;
+        if (!symbol.first.getSection(section) && section != object->getBinary()->section_end() &&
+            !section->getName(sectionName)) {
+            entry.section = sectionName;
+        }
+        sizes.push_back(entry);
+    }
+    return true;
+}
+
+bool writeSizeReport(const std::vector<std::string>& objects, const std::string& reportPath)
+{
+    std::vector<FunctionSize> sizes;
+    for (const std::string& path : objects) {
+        if (!collectSizes(path, sizes)) {
+            return false;
+        }
+    }
+
+    std::sort(sizes.begin(), sizes.end(), [](const FunctionSize& a, const FunctionSize& b) {
+        return a.size != b.size ? a.size > b.size : a.name < b.name;
+    });
+
+    std::error_code ec;
+    std::unique_ptr<raw_fd_ostream> file;
+    if (!reportPath.empty()) {
+        file.reset(new raw_fd_ostream(reportPath, ec, sys::fs::F_Text));
+        if (ec) {
+            std::cerr << "error: cannot open " << reportPath << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+    raw_ostream& out = file ? *file : outs();
+
+    uint64_t total = 0;
+    for (const FunctionSize& entry : sizes) {
+        out << entry.size << "\t" << entry.section << "\t" << entry.name << "\n";
+        total += entry.size;
+    }
+    out << total << "\ttotal\t" << sizes.size() << " functions\n";
+    out.flush();
+    return true;
+}
@@ -0,0 +1,15 @@
+#ifndef BOSOJOWO_SIZEREPORT_H
+#define BOSOJOWO_SIZEREPORT_H
+
+#include <string>
+#include <vector>
+
+/**
+ * --size-report: ukuran setiap fungsi dari tabel simbol object file,
+ * urut dari yang terbesar, beserta section-nya dan total. Ditulis ke
+ * `reportPath`, atau stdout apabila kosong. Satu baris per fungsi
+ * (`ukuran<TAB>section<TAB>nama`) supaya mudah dibandingkan antar build.
+ */
+bool writeSizeReport(const std::vector<std::string>& objects, const std::string& reportPath);
+
+#endif
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include "optimize.h"
+#include "specialize.h"
+
+using namespace llvm;
+
+// hanya satu program yang jalan per proses
+static Specializer *activeSpecializer = nullptr;
+
+/**
+ * Dipanggil dari kode program untuk setiap `khusus(...)`. Nilai yang diikat
+ * dikirim sebagai bit i64 (double di-bitcast, str sebagai alamat).
+ */
+extern "C" uint64_t jowo_khusus(const char *name, int64_t bound, const uint64_t *values)
+{
+    uint64_t address = 0;
+    if (activeSpecializer != nullptr) {
+        address = activeSpecializer->specialize(name, (unsigned)bound, values);
+    }
+    if (address == 0) {
+        // handle 0 tidak bisa dipanggil, program tidak bisa lanjut
+        fflush(stdout);
+        std::cerr << "error: cannot specialize " << name << std::endl;
+        exit(2);
+    }
+    return address;
+}
+
+Specializer::Specializer(TargetMachine& tm, const CompileOptions& opts, std::unique_ptr<Module> source) :
+    tm(tm), options(opts), source(std::move(source)), jit(tm, perfSupport(opts))
+{
+    // tanpa optimasi konstanta tidak dilipat, tidak ada gunanya di-clone
+    if (options.optLevel < 2) {
+        options.optLevel = 2;
+    }
+    options.wholeProgram = false;
+
+    activeSpecializer = this;
+    sys::DynamicLibrary::AddSymbol("jowo_khusus", (void *)&jowo_khusus);
+}
+
+Specializer::~Specializer()
+{
+    if (activeSpecializer == this) {
+        activeSpecializer = nullptr;
+    }
+}
+
+static Constant* boundConstant(Type *type, uint64_t bits)
+{
+    if (type->isDoubleTy()) {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return ConstantFP::get(type, value);
+    }
+    if (type->isPointerTy()) {
+        // str: alamat string di proses ini, tetap hidup selama program jalan
+        Constant *address = ConstantInt::get(Type::getInt64Ty(type->getContext()), bits);
+        return ConstantExpr::getIntToPtr(address, type);
+    }
+    return ConstantInt::get(type, bits);
+}
+
+uint64_t Specializer::specialize(const std::string& name, unsigned bound, const uint64_t *values)
+{
+    std::string key = name;
+    for (unsigned i = 0; i < bound; i++) {
+        char bits[24];
+        snprintf(bits, sizeof(bits), ":%llx", (unsigned long long)values[i]);
+        key += bits;
+    }
+    std::map<std::string, uint64_t>::iterator found = clones.find(key);
+    if (found != clones.end()) {
+        return found->second;
+    }
+
+    std::unique_ptr<Module> module(CloneModule(source.get()));
+    Function *generic = module->getFunction(name);
+    if (generic == nullptr || generic->isDeclaration() || bound > generic->arg_size()) {
+        return 0;
+    }
+
+    // argumen yang diikat dihapus dari signature clone, nilainya dilipat ke body
+    ValueToValueMapTy vmap;
+    unsigned i = 0;
+    for (Function::arg_iterator arg = generic->arg_begin(); i < bound; arg++, i++) {
+        vmap[&*arg] = boundConstant(arg->getType(), values[i]);
+    }
+    Function *clone = CloneFunction(generic, vmap, false);
+    std::string cloneName = name + ".khusus." + std::to_string(clones.size() + 1);
+    clone->setName(cloneName);
+    clone->setLinkage(GlobalValue::ExternalLinkage);
+    module->getFunctionList().push_back(clone);
+
+    // hanya clone yang diekspor, sisanya boleh di-inline atau dibuang
+    for (Function& fn : *module) {
+        if (!fn.isDeclaration() && &fn != clone) {
+            fn.setLinkage(GlobalValue::InternalLinkage);
+        }
+    }
+    for (GlobalVariable& global : module->globals()) {
+        if (!global.isDeclaration() && !global.hasAppendingLinkage()) {
+            global.setLinkage(GlobalValue::InternalLinkage);
+        }
+    }
+
+    if (!optimizeModule(*module, tm, options, true)) {
+        return 0;
+    }
+
+    jit.addModule(std::move(module));
+    uint64_t address = jit.getAddress(cloneName);
+    if (address != 0) {
+        clones[key] = address;
+    }
+    return address;
+}
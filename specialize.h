@@ -0,0 +1,41 @@
+#ifndef BOSOJOWO_SPECIALIZE_H
+#define BOSOJOWO_SPECIALIZE_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "jit.h"
+#include "options.h"
+
+/**
+ * Spesialisasi saat program jalan untuk builtin `khusus(f, a, b, ...)` di --jalan.
+ *
+ * Kode program memanggil `jowo_khusus` dengan nama fungsi dan bit nilai argumen
+ * yang diikat. Fungsi di-clone dari IR sebelum optimasi dengan argumen pertama
+ * diganti konstanta (seperti spesialisasi --whole-program, tapi nilainya baru
+ * diketahui saat jalan), dioptimasi -O2 atau lebih lalu di-JIT di module sendiri.
+ * Alamat clone dikembalikan sebagai handle; kombinasi fungsi + nilai yang sama
+ * memakai clone yang sudah ada.
+ */
+class Specializer {
+    llvm::TargetMachine& tm;
+    CompileOptions options;
+    std::unique_ptr<llvm::Module> source;
+    JowoJIT jit;
+    std::map<std::string, uint64_t> clones;     // nama + bit argumen -> alamat
+
+public:
+    Specializer(llvm::TargetMachine& tm, const CompileOptions& opts, std::unique_ptr<llvm::Module> source);
+    ~Specializer();
+
+    /* Alamat clone `name` dengan `bound` argumen pertama diikat, 0 apabila gagal. */
+    uint64_t specialize(const std::string& name, unsigned bound, const uint64_t *values);
+
+    unsigned cloneCount() const { return clones.size(); }
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include <iostream>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Function.h>
+#include <llvm/MC/SubtargetFeature.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include "target.h"
+
+using namespace llvm;
+
+static CodeGenOpt::Level codeGenLevel(unsigned optLevel)
+{
+    switch (optLevel) {
+        case 0: return CodeGenOpt::None;
+        case 1: return CodeGenOpt::Less;
+        case 3: return CodeGenOpt::Aggressive;
+        default: return CodeGenOpt::Default;
+    }
+}
+
+TargetMachine *createTargetMachine(const CompileOptions& opts)
+{
+    InitializeAllTargetInfos();
+    InitializeAllTargets();
+    InitializeAllTargetMCs();
+    InitializeAllAsmPrinters();
+    InitializeAllAsmParsers();
+
+    std::string hostTriple = sys::getDefaultTargetTriple();
+    std::string triple = opts.targetTriple.empty() ? hostTriple : Triple::normalize(opts.targetTriple);
+
+    std::string error;
+    const Target *target = TargetRegistry::lookupTarget(triple, error);
+    if (target == nullptr) {
+        std::cerr << "error: " << error << std::endl;
+        return nullptr;
+    }
+
+    std::string cpu = opts.cpu.empty() ? "generic" : opts.cpu;
+    SubtargetFeatures features;
+
+    // -mcpu=native: nama CPU dan fitur diambil dari mesin ini
+    if (cpu == "native") {
+        if (Triple(triple).getArch() != Triple(hostTriple).getArch()) {
+            std::cerr << "error: -mcpu=native cannot be used with --target=" << triple << std::endl;
+            return nullptr;
+        }
+        cpu = sys::getHostCPUName();
+        StringMap<bool> hostFeatures;
+        if (sys::getHostCPUFeatures(hostFeatures)) {
+            for (auto& feature : hostFeatures) {
+                features.AddFeature(feature.first(), feature.second);
+            }
+        }
+    }
+
+    // -mattr=+avx2,-fma: fitur tambahan ditulis setelah fitur host
+    // sehingga bisa menimpanya.
+    std::string attrs = opts.features;
+    size_t pos = 0;
+    while (pos <= attrs.size() && !attrs.empty()) {
+        size_t comma = attrs.find(',', pos);
+        std::string attr = attrs.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        if (!attr.empty()) {
+            features.AddFeature(attr);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+
+    TargetOptions options;
+    TargetMachine *tm = target->createTargetMachine(triple, cpu, features.getString(), options,
+                                                    opts.relocPIC ? Reloc::PIC_ : Reloc::Default,
+                                                    opts.run || opts.tiered || opts.repl ? CodeModel::JITDefault : CodeModel::Default,
+                                                    codeGenLevel(opts.optLevel));
+    if (tm == nullptr) {
+        std::cerr << "error: could not create target machine for " << triple << std::endl;
+        return nullptr;
+    }
+
+    std::cout << "Target: " << triple << ", cpu: " << cpu << std::endl;
+    return tm;
+}
+
+void configureModuleForTarget(Module& module, TargetMachine& tm)
+{
+    module.setTargetTriple(tm.getTargetTriple().str());
+    module.setDataLayout(*tm.getDataLayout());
+}
+
+void setFunctionTargetAttributes(Module& module, TargetMachine& tm)
+{
+    for (Module::iterator it = module.begin(); it != module.end(); it++) {
+        Function& function = *it;
+        if (function.isDeclaration() || function.hasFnAttribute("target-cpu")) {
+            continue;
+        }
+        function.addFnAttr("target-cpu", tm.getTargetCPU());
+        if (!tm.getTargetFeatureString().empty()) {
+            function.addFnAttr("target-features", tm.getTargetFeatureString());
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef BOSOJOWO_TARGET_H
+#define BOSOJOWO_TARGET_H
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+/**
+ * Buat TargetMachine dari opsi --target, -mcpu dan -mattr.
+ * Tanpa --target dipakai triple host. Mengembalikan nullptr apabila gagal.
+ */
+llvm::TargetMachine *createTargetMachine(const CompileOptions& opts);
+
+/* Set triple dan DataLayout target ke module. */
+void configureModuleForTarget(llvm::Module& module, llvm::TargetMachine& tm);
+
+/**
+ * Tandai setiap fungsi yang belum punya atribut "target-cpu" dengan CPU dan
+ * fitur dari TargetMachine, supaya llc dan instruction selection memakainya.
+ */
+void setFunctionTargetAttributes(llvm::Module& module, llvm::TargetMachine& tm);
+
+#endif
@@ -1,7 +1,23 @@
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include "cache.h"
 #include "codegen.h"
 #include "node.h"
+#include "emit.h"
+#include "incremental.h"
+#include "linker.h"
+#include "options.h"
+#include "optimize.h"
+#include "package.h"
+#include "remarks.h"
+#include "repl.h"
+#include "silence.h"
+#include "sizereport.h"
+#include "target.h"
+#include "thinlto.h"
+#include "tiered.h"
+#include "vm.h"
 
 
 
@@ -9,50 +25,409 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/Support/raw_os_ostream.h"
+#include "llvm/Support/FileSystem.h"
 
 //using namespace llvm;
 
 
 
 extern NBlock* programBlock;
+extern FILE* yyin;
 extern int yydebug;
 extern int yyparse();
 
+/**
+ * Catat durasi setiap tahap kompilasi untuk --time.
+ */
+class PhaseTimer {
+    std::chrono::steady_clock::time_point start;
+    bool enabled;
+public:
+    PhaseTimer(bool enabled) : start(std::chrono::steady_clock::now()), enabled(enabled) { }
+    void done(const char *phase) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (enabled) {
+            double ms = std::chrono::duration<double, std::milli>(now - start).count();
+            std::cerr << "[time] " << phase << ": " << ms << " ms" << std::endl;
+        }
+        start = now;
+    }
+};
+
+/**
+ * Generate object sementara untuk module. Dengan -j N module dipecah menjadi
+ * N object yang di-generate paralel; urutan file mengikuti nomor partisi.
+ */
+static bool writeTemporaryObjects(llvm::Module& module, llvm::TargetMachine& targetMachine,
+                                  const CompileOptions& options, std::vector<std::string>& objects)
+{
+    for (unsigned i = 0; i < options.jobs; i++) {
+        llvm::SmallString<128> objectPath;
+        if (llvm::sys::fs::createTemporaryFile("bosojowo", "o", objectPath)) {
+            std::cerr << "error: cannot create temporary object file" << std::endl;
+            return false;
+        }
+        objects.push_back(objectPath.str());
+    }
+
+    if (objects.size() == 1) {
+        return writeNativeFile(module, targetMachine, objects[0], llvm::TargetMachine::CGFT_ObjectFile);
+    }
+    return writeNativeFilesParallel(module, targetMachine, objects);
+}
+
+static void removeFiles(const std::vector<std::string>& paths)
+{
+    for (const std::string& path : paths) {
+        llvm::sys::fs::remove(path);
+    }
+}
+
+/* Nama entri cache untuk object ke-i dari -j N, satu object cukup KEY.o. */
+static std::string cachedObjectName(const std::string& key, const CompileOptions& options, unsigned i)
+{
+    return options.jobs > 1 ? key + "." + std::to_string(i) + ".o" : key + ".o";
+}
+
+/**
+ * --cache: pakai hasil kompilasi sebelumnya. Object dan bitcode langsung
+ * disalin ke output, executable tetap di-link dari object di cache.
+ * Mengembalikan -1 apabila belum ada di cache, selain itu exit status.
+ */
+static int restoreCachedOutput(CompileCache& cache, const std::string& key,
+                               const CompileOptions& options, PhaseTimer& timer)
+{
+    const std::string& filePath = options.outputPath;
+
+    switch (options.outputKind) {
+        case OutputBitcode:
+            return cache.loadToFile(key + ".bc", filePath) ? 0 : -1;
+        case OutputObject:
+            return cache.loadToFile(key + ".o", filePath) ? 0 : -1;
+        case OutputExecutable: {
+            std::vector<std::string> objects;
+            bool restored = true;
+            for (unsigned i = 0; i < options.jobs && restored; i++) {
+                llvm::SmallString<128> objectPath;
+                if (llvm::sys::fs::createTemporaryFile("bosojowo", "o", objectPath)) {
+                    restored = false;
+                    break;
+                }
+                objects.push_back(objectPath.str());
+                restored = cache.loadToFile(cachedObjectName(key, options, i), objects.back());
+            }
+            if (!restored) {
+                removeFiles(objects);
+                return -1;
+            }
+            timer.done("cache");
+            bool linked = linkExecutable(objects, filePath, options);
+            removeFiles(objects);
+            if (!linked) {
+                return 2;
+            }
+            timer.done("link");
+            return 0;
+        }
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Tulis module sesuai jenis output yang diminta. Dengan `cache`, object atau
+ * bitcode hasilnya disimpan sebagai entri `cacheKey`.
+ */
+static bool writeOutput(llvm::Module& module, llvm::TargetMachine& targetMachine,
+                        const CompileOptions& options, PhaseTimer& timer,
+                        CompileCache *cache, const std::string& cacheKey)
+{
+    const std::string& filePath = options.outputPath;
+    bool written = false;
+
+    switch (options.outputKind) {
+        case OutputObject:
+            if (options.jobs > 1) {
+                // setiap partisi jadi object sendiri, lalu digabung dengan `ld -r`
+                std::vector<std::string> objects;
+                written = writeTemporaryObjects(module, targetMachine, options, objects);
+                timer.done("emit");
+                written = written && (!options.sizeReport || writeSizeReport(objects, options.sizeReportPath));
+                written = written && linkRelocatable(objects, filePath, options);
+                removeFiles(objects);
+            }else{
+                written = writeNativeFile(module, targetMachine, filePath, llvm::TargetMachine::CGFT_ObjectFile);
+                written = written && (!options.sizeReport ||
+                                      writeSizeReport(std::vector<std::string>(1, filePath), options.sizeReportPath));
+            }
+            if (written && cache != nullptr) {
+                cache->saveFile(cacheKey + ".o", filePath);
+            }
+            break;
+        case OutputAssembly:
+            if (options.jobs > 1) {
+                std::cerr << "warning: -j is ignored for -S, assembly is generated on one thread" << std::endl;
+            }
+            written = writeNativeFile(module, targetMachine, filePath, llvm::TargetMachine::CGFT_AssemblyFile);
+            break;
+        case OutputBitcode:
+            written = writeBitcode(module, filePath);
+            if (written && cache != nullptr) {
+                cache->saveFile(cacheKey + ".bc", filePath);
+            }
+            break;
+        case OutputExecutable: {
+            // object sementara, langsung di-link lalu dihapus
+            std::vector<std::string> objects;
+            written = writeTemporaryObjects(module, targetMachine, options, objects);
+            timer.done("emit");
+            for (unsigned i = 0; written && cache != nullptr && i < objects.size(); i++) {
+                cache->saveFile(cachedObjectName(cacheKey, options, i), objects[i]);
+            }
+            // ukuran dari object sebelum di-link, runtime tidak ikut dihitung
+            written = written && (!options.sizeReport || writeSizeReport(objects, options.sizeReportPath));
+            written = written && linkExecutable(objects, filePath, options);
+            removeFiles(objects);
+            break;
+        }
+        default:
+            written = writeTextIR(module, filePath);
+            break;
+    }
+
+    if (written) {
+        bool linked = options.outputKind == OutputExecutable ||
+            (options.outputKind == OutputObject && options.jobs > 1);
+        timer.done(linked ? "link" : "emit");
+    }
+    return written;
+}
+
+/* Buka file .jowo untuk parser, tanpa file sumber dibaca dari stdin. */
+static bool openSource(const CompileOptions& options)
+{
+    if (options.sourcePath.empty()) {
+        return true;
+    }
+    yyin = fopen(options.sourcePath.c_str(), "r");
+    if (yyin == nullptr) {
+        std::cerr << "error: cannot open " << options.sourcePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char **argv)
 {
     
 //    llvm::LLVMContext& context = llvm::getGlobalContext();
 //    llvm::Module* module = new llvm::Module("top", context);
     
+    // executable hasil --package: jalankan bitcode yang ditempel, bukan compiler
+    std::string packaged;
+    if (readPackagedBitcode(packaged)) {
+        return runPackage(packaged);
+    }
+
     yydebug=1;
     
-    if (argc < 2){
-        std::cout << "Usage: exe [input-file]" << std::endl;
+    CompileOptions options;
+    if (!parseOptions(argc, argv, options)){
+        printUsage(argv[0]);
         return 2;
     }
     
-  yyparse();
-    
-    std::cout << "hello" << std::endl;
-    
-  std::cout << programBlock << std::endl;
-    
-//    module->dump();
-    
-    CodeGenContext context;
+    PhaseTimer timer(options.timePhases);
+
+    // --jalan: stdout milik program; pesan codegen, optimasi, partisi --lazy
+    // dan clone khusus() selama program jalan tidak ikut dicetak
+    SilenceStdout silence(options.run);
 
-    context.generateCode(*programBlock);
+    // -flto=thin dengan input .bc: import lintas file dan generate paralel per module
+    if (options.thinLTO && options.sourcePath.empty() && !options.moduleInputs.empty() &&
+        (options.outputKind == OutputExecutable || options.outputKind == OutputObject)) {
+        if (!thinLink(options)) {
+            return 2;
+        }
+        timer.done("thin link");
+        std::cout << std::endl;
+        std::cout << "out: " << options.outputPath << std::endl;
+        return 0;
+    }
+
+    // --vm: AST langsung jadi bytecode dan diinterpretasi, LLVM tidak dipakai
+    if (options.vm) {
+        if (!openSource(options)) {
+            return 2;
+        }
+        yyparse();
+        timer.done("parse");
+
+        VMProgram program;
+        if (!compileBytecode(*programBlock, program)) {
+            return 2;
+        }
+        timer.done("bytecode");
+
+        int status = runBytecode(program);
+        timer.done("run");
+        return status;
+    }
+
+    llvm::TargetMachine *targetMachine = createTargetMachine(options);
+    if (targetMachine == nullptr) {
+        return 2;
+    }
+
+    if (options.repl) {
+        return runRepl(*targetMachine, options);
+    }
+
+    // --tiered: bytecode dulu, LLVM hanya untuk fungsi yang panas
+    if (options.tiered) {
+        if (!openSource(options)) {
+            return 2;
+        }
+        yyparse();
+        timer.done("parse");
+
+        int status = runTiered(*programBlock, *targetMachine, options);
+        timer.done("run");
+        return status;
+    }
+
+    // --cache: input, compiler, target dan opsi yang sama berarti hasil yang sama
+    std::unique_ptr<CompileCache> cache;
+    std::string cacheKey;
+    if (options.cache) {
+        cacheKey = compileCacheKey(argc, argv, options, *targetMachine);
+        if (!cacheKey.empty()) {
+            cache.reset(new CompileCache(options.cacheDir, options.cacheSize));
+            int status = restoreCachedOutput(*cache, cacheKey, options, timer);
+            if (status >= 0) {
+                std::cout << "cache: " << cacheKey << std::endl;
+                std::cout << "out: " << options.outputPath << std::endl;
+                return status;
+            }
+        }
+    }
+
+    CodeGenContext context(options, targetMachine);
+
+    RemarkCollector remarks(options);
+    if (options.remarks) {
+        remarks.install(llvm::getGlobalContext());
+    }
+
+    // --incremental: hanya fungsi yang berubah (dan pemanggilnya) di-compile ulang
+    if (options.incremental) {
+        if (!openSource(options)) {
+            return 2;
+        }
+        yyparse();
+        timer.done("parse");
+
+        if (!incrementalBuild(*programBlock, argc, argv, *targetMachine, options)) {
+            return 2;
+        }
+        timer.done("incremental build");
+        if (options.remarks && !remarks.write()) {
+            return 2;
+        }
+        std::cout << std::endl;
+        std::cout << "out: " << options.outputPath << std::endl;
+        return 0;
+    }
+
+    // tanpa .jowo tapi ada .bc: hanya menggabungkan module yang sudah ada
+    if (!options.sourcePath.empty() || options.moduleInputs.empty()) {
+        if (!openSource(options)) {
+            return 2;
+        }
+
+        yyparse();
+        timer.done("parse");
+
+        context.generateCode(*programBlock);
+        if (context.errorCount > 0) {
+            std::cerr << context.errorCount << " error(s)" << std::endl;
+            return 2;
+        }
+        timer.done("codegen");
+    }else{
+        configureModuleForTarget(*context.module, *targetMachine);
+    }
+
+    std::string mainOrigin;
+    if (Function *main = context.module->getFunction("main")) {
+        if (!main->isDeclaration()) {
+            mainOrigin = options.sourcePath.empty() ? "<stdin>" : options.sourcePath;
+        }
+    }
+    for (const std::string& input : options.moduleInputs) {
+        if (!linkModuleFile(*context.module, input, mainOrigin)) {
+            return 2;
+        }
+    }
+    if (!options.moduleInputs.empty()) {
+        timer.done("read");
+    }
+
+    if (options.run) {
+        context.keepSpecializeSource();
+    }
+
+    // --lazy: optimasi per fungsi di JIT ketika fungsinya pertama kali dipanggil
+    CompileOptions upfront = options;
+    if (options.run && options.lazyJIT) {
+        upfront.optLevel = 0;
+    }
+    if (!optimizeModule(*context.module, *targetMachine, upfront)) {
+        return 2;
+    }
+    timer.done("optimize");
+
+    if (options.run) {
+        if (options.remarks && !remarks.write()) {
+            return 2;
+        }
+        int status = context.runCode();
+        timer.done("run");
+        return status;
+    }
+
+    if (options.package) {
+        if (!writePackage(*context.module, options.outputPath)) {
+            return 2;
+        }
+        timer.done("package");
+        std::cout << std::endl;
+        std::cout << "out: " << options.outputPath << std::endl;
+        return 0;
+    }
+
+    if (options.thinLTO) {
+        addThinSummary(*context.module);
+    }
 //    context.module->dump();
 //    context.runCode();
     
-    {
-        std::string filePath = std::string(argv[1]);
-        std::ofstream outFile(filePath, std::ios::binary);
-        raw_os_ostream outFileOsStream(outFile);
-        context.module->print(outFileOsStream, nullptr);
-        std::cout << std::endl;
-        std::cout << "out: " << filePath << std::endl;
+    // bitcode hasil optimasi ikut disimpan, untuk --emit-bc dengan opsi yang sama
+    if (cache && options.outputKind != OutputBitcode) {
+        std::string bitcode;
+        llvm::raw_string_ostream bitcodeOut(bitcode);
+        llvm::WriteBitcodeToFile(context.module, bitcodeOut);
+        cache->save(cacheKey + ".bc", bitcodeOut.str());
+    }
+
+    if (!writeOutput(*context.module, *targetMachine, options, timer, cache.get(), cacheKey)) {
+        return 2;
+    }
+    if (options.remarks && !remarks.write()) {
+        return 2;
     }
+    std::cout << std::endl;
+    std::cout << "out: " << options.outputPath << std::endl;
   
   return 0;
 }
@@ -0,0 +1,23 @@
+# Compile SOURCE dengan -O2 jadi executable (di-link lld dengan libjowo_rt.a),
+# jalankan, lalu bandingkan stdout-nya dengan EXPECTED.
+# Dipanggil dari ctest: cmake -DBOSOJOWO=... -DSOURCE=... -DEXPECTED=... -DOUTPUT=... -P
+
+EXECUTE_PROCESS(COMMAND ${BOSOJOWO} -O2 ${SOURCE} -o ${OUTPUT}
+                RESULT_VARIABLE result
+                OUTPUT_QUIET
+                ERROR_VARIABLE error)
+IF(NOT result EQUAL 0)
+  MESSAGE(FATAL_ERROR "bosojowo -O2 ${SOURCE} failed:\n${error}")
+ENDIF()
+
+EXECUTE_PROCESS(COMMAND ${OUTPUT}
+                RESULT_VARIABLE result
+                OUTPUT_VARIABLE actual)
+IF(NOT result EQUAL 0)
+  MESSAGE(FATAL_ERROR "${OUTPUT} exited with ${result}")
+ENDIF()
+
+FILE(READ ${EXPECTED} expected)
+IF(NOT actual STREQUAL expected)
+  MESSAGE(FATAL_ERROR "unexpected output from ${OUTPUT}:\n${actual}\nexpected:\n${expected}")
+ENDIF()
@@ -0,0 +1,345 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include "emit.h"
+#include "linker.h"
+#include "optimize.h"
+#include "remarks.h"
+#include "sizereport.h"
+#include "target.h"
+#include "thinlto.h"
+
+using namespace llvm;
+
+static const char *kSummaryName = "bosojowo.summary";
+
+/* Entri index untuk satu fungsi yang diekspor. */
+struct FunctionSummary {
+    unsigned module;        // indeks di opts.moduleInputs
+    unsigned instructions;
+    bool importable;
+};
+
+typedef std::map<std::string, FunctionSummary> SummaryIndex;
+
+/* Global yang dipakai constant, termasuk di dalam constant expression (GEP string literal). */
+static void collectGlobals(Constant *constant, std::set<GlobalValue*>& globals)
+{
+    if (GlobalValue *gv = dyn_cast<GlobalValue>(constant)) {
+        globals.insert(gv);
+        return;
+    }
+    for (unsigned i = 0; i < constant->getNumOperands(); i++) {
+        collectGlobals(cast<Constant>(constant->getOperand(i)), globals);
+    }
+}
+
+static void referencedGlobals(Function& function, std::set<GlobalValue*>& globals)
+{
+    for (BasicBlock& bb : function) {
+        for (Instruction& inst : bb) {
+            for (unsigned i = 0; i < inst.getNumOperands(); i++) {
+                if (Constant *constant = dyn_cast<Constant>(inst.getOperand(i))) {
+                    collectGlobals(constant, globals);
+                }
+            }
+        }
+    }
+}
+
+/* String literal boleh disalin; global lokal lain (tabel memo, pointer `panas`) tidak. */
+static bool isCopyableLocal(GlobalValue *gv)
+{
+    GlobalVariable *var = dyn_cast<GlobalVariable>(gv);
+    return var != nullptr && var->isConstant() && var->hasInitializer();
+}
+
+bool isImportable(Function& function)
+{
+    std::set<GlobalValue*> globals;
+    referencedGlobals(function, globals);
+    for (GlobalValue *gv : globals) {
+        if (gv->hasLocalLinkage() && !isCopyableLocal(gv)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void addThinSummary(Module& module)
+{
+    LLVMContext& ctx = module.getContext();
+
+    if (NamedMDNode *old = module.getNamedMetadata(kSummaryName)) {
+        module.eraseNamedMetadata(old);
+    }
+    NamedMDNode *summary = module.getOrInsertNamedMetadata(kSummaryName);
+
+    for (Function& function : module) {
+        if (function.isDeclaration() || !function.hasExternalLinkage() || function.getName() == "main") {
+            continue;
+        }
+
+        unsigned instructions = 0;
+        for (BasicBlock& bb : function) {
+            instructions += bb.size();
+        }
+
+        Metadata *fields[] = {
+            MDString::get(ctx, function.getName()),
+            ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(ctx), instructions)),
+            ConstantAsMetadata::get(ConstantInt::get(Type::getInt1Ty(ctx), isImportable(function)))
+        };
+        summary->addOperand(MDNode::get(ctx, fields));
+    }
+}
+
+/**
+ * Baca summary semua input menjadi satu index. Module dibaca lazy sehingga
+ * body fungsi tidak di-parse.
+ */
+static bool readSummaries(const std::vector<std::string>& inputs, SummaryIndex& index)
+{
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        LLVMContext ctx;
+        SMDiagnostic err;
+        std::unique_ptr<Module> module = getLazyIRFileModule(inputs[i], err, ctx);
+        if (!module) {
+            err.print(inputs[i].c_str(), errs());
+            return false;
+        }
+
+        NamedMDNode *summary = module->getNamedMetadata(kSummaryName);
+        if (summary == nullptr) {
+            std::cerr << "warning: " << inputs[i] << " has no summary (not compiled with -flto=thin), "
+                      << "nothing is imported from it" << std::endl;
+            continue;
+        }
+
+        for (unsigned j = 0; j < summary->getNumOperands(); j++) {
+            MDNode *entry = summary->getOperand(j);
+            std::string name = cast<MDString>(entry->getOperand(0))->getString();
+
+            SummaryIndex::iterator existing = index.find(name);
+            if (existing != index.end()) {
+                std::cerr << "error: function " << name << " is defined in both "
+                          << inputs[existing->second.module] << " and " << inputs[i] << std::endl;
+                return false;
+            }
+
+            FunctionSummary fs;
+            fs.module = i;
+            fs.instructions = (unsigned)mdconst::extract<ConstantInt>(entry->getOperand(1))->getZExtValue();
+            fs.importable = mdconst::extract<ConstantInt>(entry->getOperand(2))->isOne();
+            index[name] = fs;
+        }
+    }
+    return true;
+}
+
+void importFunction(Module& dest, Function& decl, Function& source)
+{
+    ValueToValueMapTy vmap;
+
+    std::set<GlobalValue*> globals;
+    referencedGlobals(source, globals);
+    for (GlobalValue *gv : globals) {
+        if (gv == &source) {
+            vmap[gv] = &decl;
+        }else if (gv->hasLocalLinkage()) {
+            // string literal: salinan private di module tujuan
+            GlobalVariable *var = cast<GlobalVariable>(gv);
+            GlobalVariable *copy = new GlobalVariable(dest, var->getType()->getElementType(), true,
+                                                      var->getLinkage(), var->getInitializer(), var->getName());
+            copy->setUnnamedAddr(var->hasUnnamedAddr());
+            copy->setAlignment(var->getAlignment());
+            vmap[gv] = copy;
+        }else if (Function *callee = dyn_cast<Function>(gv)) {
+            vmap[gv] = dest.getOrInsertFunction(callee->getName(), callee->getFunctionType(),
+                                                callee->getAttributes());
+        }else{
+            vmap[gv] = dest.getOrInsertGlobal(gv->getName(), gv->getType()->getElementType());
+        }
+    }
+
+    Function::arg_iterator destArg = decl.arg_begin();
+    for (Function::arg_iterator it = source.arg_begin(); it != source.arg_end(); it++, destArg++) {
+        destArg->setName(it->getName());
+        vmap[&*it] = &*destArg;
+    }
+
+    SmallVector<ReturnInst*, 8> returns;
+    CloneFunctionInto(&decl, &source, vmap, true, returns);
+    decl.setLinkage(GlobalValue::AvailableExternallyLinkage);
+}
+
+/**
+ * Import fungsi dari file lain untuk setiap deklarasi di `module` yang ada di
+ * index, kecil (<= --import-limit) dan bisa disalin. Diulang sampai tidak ada
+ * yang baru, karena body yang di-import bisa memanggil fungsi lain.
+ */
+static unsigned importFunctions(Module& module, unsigned self, const std::vector<std::string>& inputs,
+                                const SummaryIndex& index, const CompileOptions& opts)
+{
+    std::map<unsigned, std::unique_ptr<Module> > sources;
+    unsigned imported = 0;
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        std::vector<Function*> decls;
+        for (Function& function : module) {
+            if (function.isDeclaration()) {
+                decls.push_back(&function);
+            }
+        }
+
+        for (Function *decl : decls) {
+            SummaryIndex::const_iterator entry = index.find(decl->getName());
+            if (entry == index.end() || entry->second.module == self ||
+                !entry->second.importable || entry->second.instructions > opts.importLimit) {
+                continue;
+            }
+
+            std::unique_ptr<Module>& source = sources[entry->second.module];
+            if (!source) {
+                SMDiagnostic err;
+                source = getLazyIRFileModule(inputs[entry->second.module], err, module.getContext());
+                if (!source) {
+                    err.print(inputs[entry->second.module].c_str(), errs());
+                    continue;
+                }
+            }
+
+            Function *definition = source->getFunction(decl->getName());
+            if (definition == nullptr || definition->getFunctionType() != decl->getFunctionType()) {
+                std::cerr << "warning: " << decl->getName().str() << " in " << inputs[self]
+                          << " does not match its definition, not imported" << std::endl;
+                continue;
+            }
+            if (definition->materialize()) {
+                continue;
+            }
+
+            importFunction(module, *decl, *definition);
+            imported++;
+            changed = true;
+        }
+    }
+    return imported;
+}
+
+/* Satu unit kerja: baca, import, optimasi dan generate object untuk satu file. */
+static bool compileModule(unsigned self, const std::vector<std::string>& inputs, const SummaryIndex& index,
+                          TargetMachine& tm, const CompileOptions& opts, const std::string& objectPath,
+                          RemarkCollector& remarks)
+{
+    LLVMContext ctx;
+    if (opts.remarks) {
+        remarks.install(ctx);
+    }
+    SMDiagnostic err;
+    std::unique_ptr<Module> module = parseIRFile(inputs[self], err, ctx);
+    if (!module) {
+        err.print(inputs[self].c_str(), errs());
+        return false;
+    }
+
+    unsigned imported = importFunctions(*module, self, inputs, index, opts);
+    std::cout << "Imported " << imported << " functions into " << inputs[self] << std::endl;
+
+    if (!optimizeModule(*module, tm, opts)) {
+        return false;
+    }
+    return writeNativeFile(*module, tm, objectPath, TargetMachine::CGFT_ObjectFile);
+}
+
+bool thinLink(const CompileOptions& opts)
+{
+    const std::vector<std::string>& inputs = opts.moduleInputs;
+
+    SummaryIndex index;
+    if (!readSummaries(inputs, index)) {
+        return false;
+    }
+
+    // tanpa -j pakai semua core, tapi tidak lebih dari jumlah file
+    unsigned threads = opts.jobs > 1 ? opts.jobs : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min(threads, (unsigned)inputs.size()));
+
+    // TargetMachine tidak thread safe, satu per worker
+    std::vector<std::unique_ptr<TargetMachine> > machines;
+    for (unsigned t = 0; t < threads; t++) {
+        TargetMachine *tm = createTargetMachine(opts);
+        if (tm == nullptr) {
+            return false;
+        }
+        machines.push_back(std::unique_ptr<TargetMachine>(tm));
+    }
+
+    std::vector<std::string> objects;
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        SmallString<128> objectPath;
+        if (sys::fs::createTemporaryFile("bosojowo-thin", "o", objectPath)) {
+            std::cerr << "error: cannot create temporary object file" << std::endl;
+            return false;
+        }
+        objects.push_back(objectPath.str());
+    }
+
+    std::cout << "ThinLTO: " << inputs.size() << " modules, " << index.size()
+              << " exported functions, " << threads << " threads" << std::endl;
+
+    RemarkCollector remarks(opts);
+    std::vector<char> compiled(inputs.size(), 0);
+    std::atomic<unsigned> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            for (unsigned i = next++; i < inputs.size(); i = next++) {
+                compiled[i] = compileModule(i, inputs, index, *machines[t], opts, objects[i], remarks);
+            }
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    bool linked = std::find(compiled.begin(), compiled.end(), 0) == compiled.end();
+    if (linked && opts.remarks) {
+        linked = remarks.write();
+    }
+    if (linked && opts.sizeReport) {
+        linked = writeSizeReport(objects, opts.sizeReportPath);
+    }
+    if (linked) {
+        if (opts.outputKind == OutputObject) {
+            linked = linkRelocatable(objects, opts.outputPath, opts);
+        }else{
+            linked = linkExecutable(objects, opts.outputPath, opts);
+        }
+    }
+
+    for (const std::string& object : objects) {
+        sys::fs::remove(object);
+    }
+    return linked;
+}
@@ -0,0 +1,39 @@
+#ifndef BOSOJOWO_THINLTO_H
+#define BOSOJOWO_THINLTO_H
+
+#include <llvm/IR/Module.h>
+
+#include "options.h"
+
+/**
+ * Tambahkan summary ThinLTO ke module hasil kompile satu file .jowo.
+ *
+ * Summary berupa named metadata `bosojowo.summary`, satu entri per fungsi
+ * yang diekspor: nama, jumlah instruksi dan apakah body-nya bisa disalin
+ * ke module lain (tidak memakai global lokal selain string literal).
+ * Tahap link cukup membaca summary ini tanpa materialize body fungsi.
+ */
+void addThinSummary(llvm::Module& module);
+
+/**
+ * Tahap link -flto=thin untuk file .bc di `opts.moduleInputs`.
+ *
+ * Summary semua file dibaca menjadi satu index, lalu setiap module diproses
+ * di thread sendiri (LLVMContext sendiri): fungsi kecil dari file lain di-import
+ * sebagai available_externally supaya bisa di-inline, module dioptimasi dan
+ * di-generate menjadi object. Semua object lalu di-link menjadi executable,
+ * atau satu object untuk -c.
+ */
+bool thinLink(const CompileOptions& opts);
+
+/* Body fungsi bisa disalin ke module lain: tidak memakai global lokal selain string literal. */
+bool isImportable(llvm::Function& function);
+
+/**
+ * Salin body `source` ke deklarasi `decl` di module tujuan sebagai
+ * available_externally: boleh di-inline, tapi definisinya tetap milik
+ * module asal sehingga tidak di-generate dua kali. Dipakai juga oleh JIT lazy.
+ */
+void importFunction(llvm::Module& dest, llvm::Function& decl, llvm::Function& source);
+
+#endif
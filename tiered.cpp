@@ -0,0 +1,313 @@
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include "node.h"
+#include "codegen.h"
+#include "jit.h"
+#include "optimize.h"
+#include "tiered.h"
+#include "vm.h"
+
+struct Promotion {
+    unsigned function;
+    uint32_t calls;         // counter ketika fungsi dinyatakan panas
+    uint32_t backEdges;
+    double queuedMs;        // sejak program mulai
+    double readyMs;
+    bool compiled;
+    std::string failure;
+};
+
+/**
+ * Pintu masuk kode native dengan bentuk yang sama untuk semua fungsi:
+ * `void f.tier(i64 *args)`. Argumen dibaca dari slot register VM sesuai jenis
+ * parameternya, hasil ditulis ke slot pertama.
+ */
+static Function* createTierEntry(Module& module, Function& target)
+{
+    LLVMContext& ctx = module.getContext();
+    Type *slotTy = Type::getInt64Ty(ctx)->getPointerTo();
+    std::vector<Type*> params(1, slotTy);
+    FunctionType *ftype = FunctionType::get(Type::getVoidTy(ctx), params, false);
+    Function *entry = Function::Create(ftype, GlobalValue::ExternalLinkage,
+                                       target.getName() + ".tier", &module);
+
+    IRBuilder<> builder(BasicBlock::Create(ctx, "entry", entry));
+    Value *slots = &*entry->arg_begin();
+
+    std::vector<Value*> args;
+    unsigned i = 0;
+    for (Function::arg_iterator it = target.arg_begin(); it != target.arg_end(); it++, i++) {
+        Value *slot = builder.CreateConstGEP1_32(slots, i);
+        slot = builder.CreateBitCast(slot, it->getType()->getPointerTo());
+        args.push_back(builder.CreateLoad(slot));
+    }
+
+    CallInst *call = builder.CreateCall(&target, args);
+    if (!target.getReturnType()->isVoidTy()) {
+        builder.CreateStore(call, builder.CreateBitCast(slots, target.getReturnType()->getPointerTo()));
+    }
+    builder.CreateRetVoid();
+
+    return entry;
+}
+
+class TieredRunner : public VMTier {
+    NBlock& root;
+    TargetMachine& tm;
+    CompileOptions nativeOptions;       // opsi untuk IR dan optimasi tingkat native
+    const VMProgram& program;
+    std::chrono::steady_clock::time_point start;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<size_t> queue;           // index ke `promotions`
+    std::vector<Promotion> promotions;
+    bool stopping;
+
+    // hanya disentuh thread compiler
+    std::unique_ptr<CodeGenContext> codegen;
+    std::unique_ptr<JowoJIT> jit;
+    std::set<std::string> brokenFunctions;    // IR tidak valid, tidak pernah dipromosikan
+
+    std::thread worker;
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void work();
+    bool reachesBrokenFunction(Function& function);
+    uint64_t compile(unsigned function, std::string& failure);
+
+public:
+    TieredRunner(NBlock& root, TargetMachine& tm, const CompileOptions& opts, const VMProgram& program) :
+        VMTier(program.functions.size(), opts.tierThreshold), root(root), tm(tm), nativeOptions(opts),
+        program(program), start(std::chrono::steady_clock::now()), stopping(false) {
+
+        nativeOptions.run = true;       // tanpa cetak IR
+        nativeOptions.wholeProgram = false;
+        worker = std::thread(&TieredRunner::work, this);
+    }
+
+    ~TieredRunner() {
+        stop();
+    }
+
+    /* Dipanggil dari thread interpreter. */
+    virtual void hot(unsigned function) {
+        // kode top level hanya jalan sekali, tidak ada gunanya di-compile
+        if (function == 0) {
+            return;
+        }
+        Promotion promotion;
+        promotion.function = function;
+        promotion.calls = profiles[function].calls;
+        promotion.backEdges = profiles[function].backEdges;
+        promotion.queuedMs = elapsedMs();
+        promotion.readyMs = 0;
+        promotion.compiled = false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        promotions.push_back(promotion);
+        queue.push_back(promotions.size() - 1);
+        wake.notify_one();
+    }
+
+    /* Tunggu kompilasi yang sedang berjalan, sisa antrian dibatalkan. */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            wake.notify_one();
+        }
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    void report(std::ostream& out);
+};
+
+void TieredRunner::work()
+{
+    for (;;) {
+        size_t index;
+        unsigned function;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            index = queue.front();
+            queue.pop_front();
+            function = promotions[index].function;
+        }
+
+        std::string failure;
+        uint64_t address = compile(function, failure);
+        if (address != 0) {
+            profiles[function].native.store((VMNativeEntry)(intptr_t)address, std::memory_order_release);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        promotions[index].readyMs = elapsedMs();
+        promotions[index].compiled = address != 0;
+        promotions[index].failure = failure;
+    }
+}
+
+/* `function` atau salah satu fungsi yang dipanggilnya (langsung maupun tidak) ada di brokenFunctions. */
+bool TieredRunner::reachesBrokenFunction(Function& function)
+{
+    std::set<Function*> visited;
+    std::vector<Function*> pending(1, &function);
+    while (!pending.empty()) {
+        Function *fn = pending.back();
+        pending.pop_back();
+        if (!visited.insert(fn).second) {
+            continue;
+        }
+        if (brokenFunctions.count(fn->getName().str())) {
+            return true;
+        }
+        for (BasicBlock& bb : *fn) {
+            for (Instruction& inst : bb) {
+                CallInst *call = dyn_cast<CallInst>(&inst);
+                Function *callee = call != nullptr ? call->getCalledFunction() : nullptr;
+                if (callee != nullptr && !callee->isDeclaration()) {
+                    pending.push_back(callee);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Compile satu fungsi panas. IR seluruh program dibuat sekali saat promosi
+ * pertama; setiap promosi memakai salinannya di mana hanya pintu masuk fungsi
+ * itu yang diekspor, sehingga fungsi lain yang tidak dipanggilnya dibuang
+ * optimizer dan callee-nya bisa di-inline.
+ */
+uint64_t TieredRunner::compile(unsigned function, std::string& failure)
+{
+    if (!codegen) {
+        codegen.reset(new CodeGenContext(nativeOptions, &tm));
+        codegen->generateCode(root);
+        jit.reset(new JowoJIT(tm, perfSupport(nativeOptions)));
+
+        // diperiksa sekali di sini, bukan oleh verifier setiap promosi
+        for (Function& fn : *codegen->module) {
+            if (!fn.isDeclaration() && verifyFunction(fn)) {
+                brokenFunctions.insert(fn.getName().str());
+            }
+        }
+    }
+    if (codegen->errorCount > 0) {
+        failure = "codegen failed";
+        return 0;
+    }
+
+    const std::string& name = program.functions[function].name;
+    Function *original = codegen->module->getFunction(name);
+    if (original == nullptr || original->isDeclaration()) {
+        failure = "not found in IR";
+        return 0;
+    }
+    if (reachesBrokenFunction(*original)) {
+        failure = "invalid IR";
+        return 0;
+    }
+
+    std::unique_ptr<Module> module(CloneModule(codegen->module));
+    Function *target = module->getFunction(name);
+    // fungsi lain yang tidak valid tidak dipanggil target, cukup jadi deklarasi
+    for (const std::string& broken : brokenFunctions) {
+        module->getFunction(broken)->deleteBody();
+    }
+
+    Function *entry = createTierEntry(*module, *target);
+    std::string entryName = entry->getName();
+
+    for (Function& fn : *module) {
+        if (!fn.isDeclaration() && &fn != entry) {
+            fn.setLinkage(GlobalValue::InternalLinkage);
+        }
+    }
+    for (GlobalVariable& global : module->globals()) {
+        if (!global.isDeclaration() && !global.hasAppendingLinkage()) {
+            global.setLinkage(GlobalValue::InternalLinkage);
+        }
+    }
+
+    if (!optimizeModule(*module, tm, nativeOptions, true)) {
+        failure = "invalid IR";
+        return 0;
+    }
+
+    jit->addModule(std::move(module));
+    uint64_t address = jit->getAddress(entryName);
+    if (address == 0) {
+        failure = "JIT failed";
+    }
+    return address;
+}
+
+void TieredRunner::report(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    unsigned compiled = 0;
+    for (const Promotion& promotion : promotions) {
+        compiled += promotion.compiled ? 1 : 0;
+    }
+    out << "tiered: " << compiled << " of " << program.functions.size() - 1
+        << " functions promoted (threshold " << threshold << ")" << std::endl;
+
+    for (const Promotion& promotion : promotions) {
+        out << "  " << program.functions[promotion.function].name
+            << ": hot after " << promotion.calls << " calls, " << promotion.backEdges
+            << " back-edges at " << promotion.queuedMs << " ms, ";
+        if (promotion.compiled) {
+            out << "native at " << promotion.readyMs << " ms, "
+                << profiles[promotion.function].calls << " calls interpreted";
+        }else if (!promotion.failure.empty()) {
+            out << "not promoted: " << promotion.failure;
+        }else{
+            out << "still compiling when the program ended";
+        }
+        out << std::endl;
+    }
+}
+
+int runTiered(NBlock& root, TargetMachine& tm, const CompileOptions& opts)
+{
+    VMProgram program;
+    if (!compileBytecode(root, program)) {
+        return 2;
+    }
+
+    // codegen di thread compiler mencetak ke std::cout, stdout milik program
+    std::streambuf *stdoutBuf = std::cout.rdbuf(nullptr);
+
+    TieredRunner runner(root, tm, opts, program);
+    int status = runBytecode(program, &runner);
+    runner.stop();
+
+    std::cout.rdbuf(stdoutBuf);
+    std::cout.clear();
+
+    runner.report(std::cerr);
+    return status;
+}
@@ -0,0 +1,24 @@
+#ifndef BOSOJOWO_TIERED_H
+#define BOSOJOWO_TIERED_H
+
+#include <llvm/Target/TargetMachine.h>
+
+#include "options.h"
+
+class NBlock;
+
+/**
+ * Eksekusi bertingkat untuk `--tiered`: program langsung jalan di interpreter
+ * bytecode (vm.h), fungsi yang panggilan + back-edge-nya mencapai
+ * `opts.tierThreshold` di-compile (-O2 kecuali -O lain diberikan) oleh thread
+ * compiler di belakang, lalu panggilan berikutnya masuk ke kode native.
+ * Kode top level tidak pernah dipromosikan (tidak ada on-stack replacement),
+ * begitu juga panggilan yang sedang berjalan ketika kode native-nya selesai.
+ *
+ * Setelah program selesai dicetak laporan ke stderr: fungsi mana yang
+ * dipromosikan, setelah berapa panggilan dan kapan kode native-nya siap.
+ * Mengembalikan exit status program.
+ */
+int runTiered(NBlock& root, llvm::TargetMachine& tm, const CompileOptions& opts);
+
+#endif
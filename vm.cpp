@@ -0,0 +1,821 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#include "node.h"
+#include "parser.hpp"
+#include "stringutil.h"
+#include "vm.h"
+
+// labels-as-values (GCC/Clang): satu indirect jump di akhir setiap opcode,
+// prediksi cabangnya per opcode, bukan satu jump bersama seperti switch
+#if defined(__GNUC__)
+#define BOSOJOWO_VM_COMPUTED_GOTO
+#endif
+
+static const unsigned kMaxOperand = 0xffff;
+static const size_t kStackSize = 1 << 20;   // register untuk semua frame
+static const size_t kMaxFrames = 1 << 16;
+static const int kNoTarget = -1;
+
+static VMType typeOf(const NIdentifier *type)
+{
+    if (type == nullptr) {
+        return VMVoid;
+    }
+    if (type->name == "int") {
+        return VMInt;
+    }else if (type->name == "double") {
+        return VMDouble;
+    }else if (type->name == "str") {
+        return VMStr;
+    }
+    return VMVoid;
+}
+
+struct VMLocal {
+    unsigned reg;
+    VMType type;
+};
+
+/**
+ * AST -> bytecode. Variabel lokal mendapat register tetap selama scope-nya,
+ * nilai sementara memakai register di atasnya seperti stack dan dibebaskan
+ * setelah expression selesai. Argumen panggilan ditaruh berurutan di puncak
+ * register sehingga frame fungsi yang dipanggil dimulai tepat di argumen pertama.
+ */
+class BytecodeCompiler {
+    VMProgram& program;
+    std::map<std::string, unsigned> functionIndex;
+    std::vector<NFunctionDeclaration*> declarations;    // index sama dengan program.functions
+    VMFunction *function;
+    NFunctionDeclaration *currentDecl;
+    std::vector<std::map<std::string, VMLocal> > scopes;
+    std::vector<unsigned> scopeMarks;
+    unsigned freeReg;
+    int errorCount;
+
+    void error(int line, const std::string& msg) {
+        std::cerr << "error: line " << line << ": " << msg << std::endl;
+        errorCount++;
+    }
+
+    unsigned temp() {
+        unsigned reg = freeReg++;
+        if (freeReg > function->numRegisters) {
+            function->numRegisters = freeReg;
+        }
+        return reg;
+    }
+
+    size_t emit(VMOpcode op, unsigned a, unsigned b = 0, unsigned c = 0) {
+        VMInstr instr = { (uint16_t)op, (uint16_t)a, (uint16_t)b, (uint16_t)c };
+        function->code.push_back(instr);
+        return function->code.size() - 1;
+    }
+
+    unsigned constant(VMValue value) {
+        function->constants.push_back(value);
+        return function->constants.size() - 1;
+    }
+
+    void pushScope() {
+        scopes.push_back(std::map<std::string, VMLocal>());
+        scopeMarks.push_back(freeReg);
+    }
+
+    void popScope() {
+        freeReg = scopeMarks.back();
+        scopeMarks.pop_back();
+        scopes.pop_back();
+    }
+
+    const VMLocal *lookup(const std::string& name) {
+        for (size_t i = scopes.size(); i > 0; i--) {
+            std::map<std::string, VMLocal>::const_iterator it = scopes[i - 1].find(name);
+            if (it != scopes[i - 1].end()) {
+                return &it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /* Samakan jenis nilai di `reg` dengan jenis tujuan, int dinaikkan ke double. */
+    bool convert(unsigned reg, VMType from, VMType to, int line) {
+        if (from == to) {
+            return true;
+        }
+        if (from == VMInt && to == VMDouble) {
+            emit(OP_I2D, reg, reg);
+            return true;
+        }
+        error(line, "type mismatch");
+        return false;
+    }
+
+    void collect(NBlock& block);
+    void collectExpression(NExpression& expr);
+    void compileFunction(unsigned index);
+    VMType compileBlock(NBlock& block, int target);
+    VMType compileStatement(NStatement& stmt, int target);
+    VMType compileExpr(NExpression& expr, unsigned target);
+    VMType compileCall(NMethodCall& call, unsigned target);
+    VMType compileBinary(NBinaryOperator& binary, unsigned target);
+    VMType compileConditional(NConditionalBlock& conditional, unsigned target);
+    VMType compileLoop(NLoop& loop);
+
+public:
+    BytecodeCompiler(VMProgram& program) :
+        program(program), function(nullptr), currentDecl(nullptr), freeReg(0), errorCount(0) { }
+
+    bool compile(NBlock& root);
+};
+
+/* Daftarkan semua fungsi lebih dulu supaya urutan deklarasi tidak penting. */
+void BytecodeCompiler::collect(NBlock& block)
+{
+    for (NStatement *stmt : block.statements) {
+        if (NFunctionDeclaration *decl = dynamic_cast<NFunctionDeclaration*>(stmt)) {
+            if (functionIndex.count(decl->id.name)) {
+                error(decl->line, "function " + decl->id.name + " is already defined");
+                continue;
+            }
+            VMFunction fn;
+            fn.name = decl->id.name;
+            fn.returnType = typeOf(decl->type);
+            for (NVariableDeclaration *arg : decl->arguments) {
+                fn.argTypes.push_back(typeOf(&arg->type));
+            }
+            fn.numRegisters = fn.argTypes.size();
+            fn.line = decl->line;
+            functionIndex[fn.name] = program.functions.size();
+            program.functions.push_back(fn);
+            declarations.push_back(decl);
+            collect(decl->block);
+        }else if (NExpressionStatement *exprStmt = dynamic_cast<NExpressionStatement*>(stmt)) {
+            collectExpression(exprStmt->expression);
+        }
+    }
+}
+
+void BytecodeCompiler::collectExpression(NExpression& expr)
+{
+    if (NConditionalBlock *conditional = dynamic_cast<NConditionalBlock*>(&expr)) {
+        collect(*conditional->thenStmt);
+        collect(*conditional->elseStmt);
+    }else if (NLoop *loop = dynamic_cast<NLoop*>(&expr)) {
+        collect(*loop->block);
+    }
+}
+
+bool BytecodeCompiler::compile(NBlock& root)
+{
+    VMFunction main;
+    main.name = "main";
+    main.returnType = VMVoid;
+    main.numRegisters = 0;
+    main.line = 1;
+    program.functions.push_back(main);
+    declarations.push_back(nullptr);
+
+    collect(root);
+
+    function = &program.functions[0];
+    pushScope();
+    compileBlock(root, kNoTarget);
+    emit(OP_RETV, 0);
+    popScope();
+
+    for (unsigned i = 1; i < program.functions.size(); i++) {
+        compileFunction(i);
+    }
+
+    for (const VMFunction& fn : program.functions) {
+        if (fn.code.size() > kMaxOperand || fn.numRegisters > kMaxOperand ||
+            fn.constants.size() > kMaxOperand) {
+            error(fn.line, "function " + fn.name + " is too large for the bytecode VM");
+        }
+    }
+    if (program.functions.size() > kMaxOperand) {
+        error(1, "too many functions for the bytecode VM");
+    }
+
+    return errorCount == 0;
+}
+
+void BytecodeCompiler::compileFunction(unsigned index)
+{
+    NFunctionDeclaration *decl = declarations[index];
+    function = &program.functions[index];
+    currentDecl = decl;
+
+    // argumen menempati R[0..n-1], diisi oleh pemanggil
+    freeReg = 0;
+    pushScope();
+    for (size_t i = 0; i < decl->arguments.size(); i++) {
+        VMLocal local = { temp(), function->argTypes[i] };
+        scopes.back()[decl->arguments[i]->id.name] = local;
+    }
+
+    compileBlock(decl->block, kNoTarget);
+    emit(OP_RETV, 0);
+    popScope();
+
+    currentDecl = nullptr;
+}
+
+/* Nilai block adalah nilai statement terakhirnya (untuk arm `nek`). */
+VMType BytecodeCompiler::compileBlock(NBlock& block, int target)
+{
+    VMType last = VMVoid;
+    for (size_t i = 0; i < block.statements.size(); i++) {
+        bool isLast = i + 1 == block.statements.size();
+        last = compileStatement(*block.statements[i], isLast ? target : kNoTarget);
+    }
+    return last;
+}
+
+VMType BytecodeCompiler::compileStatement(NStatement& stmt, int target)
+{
+    if (dynamic_cast<NFunctionDeclaration*>(&stmt) != nullptr) {
+        return VMVoid;  // sudah di-compile sendiri
+    }
+
+    if (dynamic_cast<NExternDeclaration*>(&stmt) != nullptr) {
+        error(stmt.line, "njaba functions need the LLVM backend, not --vm");
+        return VMVoid;
+    }
+
+    if (NVariableDeclaration *decl = dynamic_cast<NVariableDeclaration*>(&stmt)) {
+        VMType type = typeOf(&decl->type);
+        if (type == VMVoid) {
+            error(decl->line, "unknown type " + decl->type.name);
+            return VMVoid;
+        }
+        unsigned reg = temp();
+        if (decl->assignmentExpr != nullptr) {
+            VMType valueType = compileExpr(*decl->assignmentExpr, reg);
+            convert(reg, valueType, type, decl->line);
+        }else{
+            VMValue zero;
+            zero.i = 0;
+            emit(OP_LOADK, reg, constant(zero));
+        }
+        // variabel baru terlihat setelah inisialisasinya
+        VMLocal local = { reg, type };
+        scopes.back()[decl->id.name] = local;
+        freeReg = reg + 1;
+        return VMVoid;
+    }
+
+    if (NReturn *ret = dynamic_cast<NReturn*>(&stmt)) {
+        if (dynamic_cast<NVoidExpression*>(ret->lhs) != nullptr) {
+            emit(OP_RETV, 0);
+            return VMVoid;
+        }
+        unsigned mark = freeReg;
+        unsigned reg = temp();
+        VMType type = compileExpr(*ret->lhs, reg);
+        if (function->returnType != VMVoid) {
+            convert(reg, type, function->returnType, ret->line);
+        }
+        emit(OP_RET, reg);
+        freeReg = mark;
+        return VMVoid;
+    }
+
+    if (NExpressionStatement *exprStmt = dynamic_cast<NExpressionStatement*>(&stmt)) {
+        unsigned mark = freeReg;
+        unsigned reg = target == kNoTarget ? temp() : (unsigned)target;
+        VMType type = compileExpr(exprStmt->expression, reg);
+        freeReg = mark;
+        return type;
+    }
+
+    error(stmt.line, "unsupported statement " + stmt.kind());
+    return VMVoid;
+}
+
+VMType BytecodeCompiler::compileExpr(NExpression& expr, unsigned target)
+{
+    if (NInteger *integer = dynamic_cast<NInteger*>(&expr)) {
+        VMValue value;
+        value.i = integer->value;
+        emit(OP_LOADK, target, constant(value));
+        return VMInt;
+    }
+
+    if (NDouble *number = dynamic_cast<NDouble*>(&expr)) {
+        VMValue value;
+        value.d = number->value;
+        emit(OP_LOADK, target, constant(value));
+        return VMDouble;
+    }
+
+    if (NStr *str = dynamic_cast<NStr*>(&expr)) {
+        program.strings.push_back(str_def(str->text));
+        VMValue value;
+        value.s = program.strings.back().c_str();
+        emit(OP_LOADK, target, constant(value));
+        return VMStr;
+    }
+
+    if (NIdentifier *ident = dynamic_cast<NIdentifier*>(&expr)) {
+        const VMLocal *local = lookup(ident->name);
+        if (local == nullptr) {
+            error(ident->line, "undeclared variable " + ident->name);
+            return VMVoid;
+        }
+        if (local->reg != target) {
+            emit(OP_MOVE, target, local->reg);
+        }
+        return local->type;
+    }
+
+    if (NAssignment *assignment = dynamic_cast<NAssignment*>(&expr)) {
+        const VMLocal *found = lookup(assignment->lhs.name);
+        if (found == nullptr) {
+            error(assignment->line, "undeclared variable " + assignment->lhs.name);
+            return VMVoid;
+        }
+        VMLocal local = *found;     // scopes bisa bertambah di dalam rhs
+        VMType type = compileExpr(assignment->rhs, local.reg);
+        convert(local.reg, type, local.type, assignment->line);
+        if (local.reg != target) {
+            emit(OP_MOVE, target, local.reg);
+        }
+        return local.type;
+    }
+
+    if (NMethodCall *call = dynamic_cast<NMethodCall*>(&expr)) {
+        return compileCall(*call, target);
+    }
+
+    if (NBinaryOperator *binary = dynamic_cast<NBinaryOperator*>(&expr)) {
+        return compileBinary(*binary, target);
+    }
+
+    if (NConditionalBlock *conditional = dynamic_cast<NConditionalBlock*>(&expr)) {
+        return compileConditional(*conditional, target);
+    }
+
+    if (NLoop *loop = dynamic_cast<NLoop*>(&expr)) {
+        return compileLoop(*loop);
+    }
+
+    if (NBlock *block = dynamic_cast<NBlock*>(&expr)) {
+        return compileBlock(*block, target);
+    }
+
+    if (NStatement *stmt = dynamic_cast<NStatement*>(&expr)) {
+        return compileStatement(*stmt, target);
+    }
+
+    error(expr.line, "unsupported expression " + expr.kind());
+    return VMVoid;
+}
+
+VMType BytecodeCompiler::compileCall(NMethodCall& call, unsigned target)
+{
+    const std::string& name = call.id.name;
+    std::map<std::string, unsigned>::const_iterator found = functionIndex.find(name);
+
+    // fungsi murni hanya boleh memanggil fungsi murni lainnya
+    if (currentDecl != nullptr && currentDecl->isPure &&
+        (found == functionIndex.end() || !declarations[found->second]->isPure)) {
+        error(call.line, "pure function " + currentDecl->id.name + " calls impure function " + name);
+    }
+
+    // argumen berurutan di puncak register, frame pemanggil tidak tersentuh
+    unsigned mark = freeReg;
+    unsigned base = freeReg;
+    std::vector<VMType> types;
+    for (NExpression *arg : call.arguments) {
+        unsigned reg = temp();
+        types.push_back(compileExpr(*arg, reg));
+    }
+    if (call.arguments.empty()) {
+        temp();     // tempat hasil
+    }
+
+    VMType result = VMVoid;
+    if (found != functionIndex.end()) {
+        const VMFunction& callee = program.functions[found->second];
+        if (types.size() != callee.argTypes.size()) {
+            error(call.line, "wrong number of arguments to " + name);
+        }else{
+            for (size_t i = 0; i < types.size(); i++) {
+                convert(base + i, types[i], callee.argTypes[i], call.line);
+            }
+        }
+        emit(OP_CALL, base, found->second, types.size());
+        result = callee.returnType;
+    }else if (name == "printf") {
+        if (types.empty() || types[0] != VMStr) {
+            error(call.line, "printf needs a format string");
+        }
+        emit(OP_BUILTIN, base, BuiltinPrintf, types.size());
+        result = VMInt;
+    }else if (name == "puts" || name == "weruhi") {
+        if (types.size() != 1 || types[0] != VMStr) {
+            error(call.line, name + " needs one str argument");
+        }
+        emit(OP_BUILTIN, base, name == "puts" ? BuiltinPuts : BuiltinWeruhi, 1);
+        result = name == "puts" ? VMInt : VMVoid;
+    }else{
+        error(call.line, "no such function " + name);
+    }
+
+    if (base != target) {
+        emit(OP_MOVE, target, base);
+    }
+    freeReg = mark;
+    return result;
+}
+
+VMType BytecodeCompiler::compileBinary(NBinaryOperator& binary, unsigned target)
+{
+    unsigned mark = freeReg;
+    unsigned lhs = temp();
+    VMType lhsType = compileExpr(binary.lhs, lhs);
+    unsigned rhs = temp();
+    VMType rhsType = compileExpr(binary.rhs, rhs);
+    freeReg = mark;
+
+    if ((lhsType != VMInt && lhsType != VMDouble) || (rhsType != VMInt && rhsType != VMDouble)) {
+        error(binary.line, "operands of a binary operator must be int or double");
+        return VMVoid;
+    }
+
+    // int op int tetap int, campuran dihitung sebagai double
+    bool ints = lhsType == VMInt && rhsType == VMInt;
+    if (!ints) {
+        convert(lhs, lhsType, VMDouble, binary.line);
+        convert(rhs, rhsType, VMDouble, binary.line);
+    }
+    VMType arith = ints ? VMInt : VMDouble;
+
+    switch (binary.op) {
+        case TPLUS:  emit(ints ? OP_ADDI : OP_ADDD, target, lhs, rhs); return arith;
+        case TMINUS: emit(ints ? OP_SUBI : OP_SUBD, target, lhs, rhs); return arith;
+        case TMUL:   emit(ints ? OP_MULI : OP_MULD, target, lhs, rhs); return arith;
+        case TDIV:   emit(ints ? OP_DIVI : OP_DIVD, target, lhs, rhs); return arith;
+        case TCLT:   emit(ints ? OP_LTI : OP_LTD, target, lhs, rhs); return VMInt;
+        case TCGT:   emit(ints ? OP_GTI : OP_GTD, target, lhs, rhs); return VMInt;
+    }
+
+    error(binary.line, "comparison operator is not supported yet");
+    return VMVoid;
+}
+
+VMType BytecodeCompiler::compileConditional(NConditionalBlock& conditional, unsigned target)
+{
+    unsigned mark = freeReg;
+    unsigned cond = temp();
+    compileExpr(conditional.cond, cond);
+    freeReg = mark;
+
+    size_t jumpElse = emit(OP_JMPF, cond, 0);
+
+    pushScope();
+    VMType thenType = compileBlock(*conditional.thenStmt, target);
+    popScope();
+
+    size_t jumpEnd = emit(OP_JMP, 0, 0);
+    function->code[jumpElse].b = function->code.size();
+
+    pushScope();
+    VMType elseType = compileBlock(*conditional.elseStmt, target);
+    popScope();
+
+    function->code[jumpEnd].b = function->code.size();
+
+    return thenType == elseType ? thenType : VMVoid;
+}
+
+/* `muter from tekan until`: body dulu, lalu i + 1 <= until, sama dengan codegen. */
+VMType BytecodeCompiler::compileLoop(NLoop& loop)
+{
+    pushScope();
+
+    unsigned counter = temp();
+    VMType fromType = compileExpr(loop.exprFrom, counter);
+    convert(counter, fromType, VMDouble, loop.line);
+    VMLocal local = { counter, VMDouble };
+    scopes.back()["i"] = local;
+
+    size_t top = function->code.size();
+    compileBlock(*loop.block, kNoTarget);
+
+    unsigned until = temp();
+    VMType untilType = compileExpr(loop.exprUntil, until);
+    convert(until, untilType, VMDouble, loop.line);
+    emit(OP_FORLOOP, counter, until, top);
+
+    popScope();
+    return VMVoid;
+}
+
+bool compileBytecode(NBlock& root, VMProgram& program)
+{
+    BytecodeCompiler compiler(program);
+    return compiler.compile(root);
+}
+
+/* -- Interpreter -- */
+
+template <typename T>
+static int printSpec(const std::string& spec, T value)
+{
+    return printf(spec.c_str(), value);
+}
+
+/**
+ * printf dengan argumen dari register. Jumlah argumen baru diketahui saat
+ * runtime, jadi format dibaca sendiri dan setiap konversi dicetak terpisah.
+ * Jenis register mengikuti huruf konversinya.
+ */
+static int formatPrintf(const VMValue *args, unsigned count)
+{
+    const char *fmt = args[0].s;
+    unsigned next = 1;
+    int written = 0;
+    std::string spec;
+
+    while (*fmt != '\0') {
+        if (*fmt != '%') {
+            const char *start = fmt;
+            while (*fmt != '\0' && *fmt != '%') {
+                fmt++;
+            }
+            written += fwrite(start, 1, fmt - start, stdout);
+            continue;
+        }
+        if (fmt[1] == '%') {
+            putchar('%');
+            written++;
+            fmt += 2;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion
+        const char *start = fmt++;
+        fmt += strspn(fmt, "-+ #0");
+        fmt += strspn(fmt, "0123456789");
+        if (*fmt == '.') {
+            fmt++;
+            fmt += strspn(fmt, "0123456789");
+        }
+        spec.assign(start, fmt);
+        fmt += strspn(fmt, "hlLqjzt");  // panjang diganti sesuai jenis register
+
+        char conversion = *fmt;
+        if (conversion == '\0') {
+            written += fwrite(start, 1, fmt - start, stdout);
+            break;
+        }
+        fmt++;
+
+        if (next >= count) {
+            written += fwrite(start, 1, fmt - start, stdout);
+            continue;
+        }
+        const VMValue& arg = args[next++];
+
+        if (conversion == 'c') {
+            written += printSpec(spec + 'c', (int)arg.i);
+        }else if (strchr("diouxX", conversion) != nullptr) {
+            written += printSpec(spec + "ll" + conversion, (long long)arg.i);
+        }else if (strchr("fFeEgGaA", conversion) != nullptr) {
+            written += printSpec(spec + conversion, arg.d);
+        }else if (conversion == 's') {
+            written += printSpec(spec + 's', arg.s);
+        }else if (conversion == 'p') {
+            written += printSpec(spec + 'p', (const void *)arg.s);
+        }else{
+            written += fwrite(start, 1, fmt - start, stdout);
+        }
+    }
+
+    return written;
+}
+
+struct CallFrame {
+    const VMFunction *function;
+    const VMInstr *pc;
+    VMValue *base;
+};
+
+/* Hitung satu panggilan/back-edge, laporkan sekali begitu fungsi jadi panas. */
+static inline void countHot(VMTier *tier, unsigned function, uint32_t& counter)
+{
+    VMProfile& profile = tier->profiles[function];
+    counter++;
+    if (!profile.queued && profile.calls + profile.backEdges >= tier->threshold) {
+        profile.queued = true;
+        tier->hot(function);
+    }
+}
+
+int runBytecode(const VMProgram& program, VMTier *tier)
+{
+    std::vector<VMValue> stack(kStackSize);
+    std::vector<CallFrame> frames;
+    frames.reserve(256);
+    VMValue *stackEnd = stack.data() + stack.size();
+
+    const VMFunction *function = &program.functions[0];
+    const VMInstr *code = function->code.data();
+    const VMInstr *pc = code;
+    const VMValue *k = function->constants.data();
+    VMValue *base = stack.data();
+    const VMInstr *ins;
+
+    if (base + function->numRegisters > stackEnd) {
+        std::cerr << "error: main needs too many registers" << std::endl;
+        return 2;
+    }
+
+#ifdef BOSOJOWO_VM_COMPUTED_GOTO
+    static void *dispatch[] = {
+        &&L_MOVE, &&L_LOADK, &&L_I2D,
+        &&L_ADDD, &&L_SUBD, &&L_MULD, &&L_DIVD,
+        &&L_ADDI, &&L_SUBI, &&L_MULI, &&L_DIVI,
+        &&L_LTD, &&L_GTD, &&L_LTI, &&L_GTI,
+        &&L_JMP, &&L_JMPF, &&L_FORLOOP,
+        &&L_CALL, &&L_BUILTIN, &&L_RET, &&L_RETV
+    };
+    static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == OP_COUNT, "dispatch table out of sync with VMOpcode");
+
+#define VM_CASE(name) L_##name:
+#define VM_NEXT() ins = pc++; goto *dispatch[ins->op]
+    VM_NEXT();
+#else
+#define VM_CASE(name) case OP_##name:
+#define VM_NEXT() continue
+    for (;;) {
+        ins = pc++;
+        switch (ins->op) {
+#endif
+
+    VM_CASE(MOVE)
+        base[ins->a] = base[ins->b];
+        VM_NEXT();
+
+    VM_CASE(LOADK)
+        base[ins->a] = k[ins->b];
+        VM_NEXT();
+
+    VM_CASE(I2D)
+        base[ins->a].d = (double)base[ins->b].i;
+        VM_NEXT();
+
+    VM_CASE(ADDD)
+        base[ins->a].d = base[ins->b].d + base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(SUBD)
+        base[ins->a].d = base[ins->b].d - base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(MULD)
+        base[ins->a].d = base[ins->b].d * base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(DIVD)
+        base[ins->a].d = base[ins->b].d / base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(ADDI)
+        base[ins->a].i = base[ins->b].i + base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(SUBI)
+        base[ins->a].i = base[ins->b].i - base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(MULI)
+        base[ins->a].i = base[ins->b].i * base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(DIVI)
+        if (base[ins->c].i == 0) {
+            std::cerr << "error: division by zero in " << function->name << std::endl;
+            return 2;
+        }
+        base[ins->a].i = base[ins->b].i / base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(LTD)
+        base[ins->a].i = base[ins->b].d < base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(GTD)
+        base[ins->a].i = base[ins->b].d > base[ins->c].d;
+        VM_NEXT();
+
+    VM_CASE(LTI)
+        base[ins->a].i = base[ins->b].i < base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(GTI)
+        base[ins->a].i = base[ins->b].i > base[ins->c].i;
+        VM_NEXT();
+
+    VM_CASE(JMP)
+        pc = code + ins->b;
+        VM_NEXT();
+
+    VM_CASE(JMPF)
+        if (base[ins->a].i == 0) {
+            pc = code + ins->b;
+        }
+        VM_NEXT();
+
+    VM_CASE(FORLOOP)
+        base[ins->a].d += 1.0;
+        if (base[ins->a].d <= base[ins->b].d) {
+            pc = code + ins->c;
+            if (tier != nullptr) {
+                unsigned index = function - program.functions.data();
+                countHot(tier, index, tier->profiles[index].backEdges);
+            }
+        }
+        VM_NEXT();
+
+    VM_CASE(CALL)
+        {
+            if (tier != nullptr) {
+                // fungsi yang sudah di-compile dipanggil langsung, tanpa frame VM
+                VMProfile& profile = tier->profiles[ins->b];
+                VMNativeEntry native = profile.native.load(std::memory_order_acquire);
+                if (native != nullptr) {
+                    native(base + ins->a);
+                    VM_NEXT();
+                }
+                countHot(tier, ins->b, profile.calls);
+            }
+            const VMFunction *callee = &program.functions[ins->b];
+            VMValue *calleeBase = base + ins->a;
+            if (calleeBase + callee->numRegisters > stackEnd || frames.size() >= kMaxFrames) {
+                std::cerr << "error: stack overflow calling " << callee->name << std::endl;
+                return 2;
+            }
+            CallFrame frame = { function, pc, base };
+            frames.push_back(frame);
+            function = callee;
+            code = pc = callee->code.data();
+            k = callee->constants.data();
+            base = calleeBase;
+        }
+        VM_NEXT();
+
+    VM_CASE(BUILTIN)
+        {
+            VMValue *args = base + ins->a;
+            switch (ins->b) {
+                case BuiltinPrintf:
+                    args[0].i = formatPrintf(args, ins->c);
+                    break;
+                case BuiltinPuts:
+                    args[0].i = puts(args[0].s);
+                    break;
+                case BuiltinWeruhi:
+                    formatPrintf(args, 1);
+                    putchar('\n');
+                    break;
+            }
+        }
+        VM_NEXT();
+
+    VM_CASE(RET)
+        // R[0] frame ini adalah register hasil di frame pemanggil
+        base[0] = base[ins->a];
+        goto leave;
+
+    VM_CASE(RETV)
+    leave:
+        if (frames.empty()) {
+            fflush(stdout);
+            return 0;
+        }
+        function = frames.back().function;
+        pc = frames.back().pc;
+        base = frames.back().base;
+        frames.pop_back();
+        code = function->code.data();
+        k = function->constants.data();
+        VM_NEXT();
+
+#ifndef BOSOJOWO_VM_COMPUTED_GOTO
+        default:
+            std::cerr << "error: bad opcode " << ins->op << std::endl;
+            return 2;
+        }
+    }
+#endif
+
+#undef VM_CASE
+#undef VM_NEXT
+}
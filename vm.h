@@ -0,0 +1,129 @@
+#ifndef BOSOJOWO_VM_H
+#define BOSOJOWO_VM_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class NBlock;
+
+/* Satu register VM. Jenis isinya diketahui compiler bytecode, tidak disimpan. */
+union VMValue {
+    double d;
+    int64_t i;
+    const char *s;
+};
+
+enum VMType {
+    VMVoid,
+    VMInt,
+    VMDouble,
+    VMStr
+};
+
+/**
+ * Opcode bytecode. Operand a, b, c adalah nomor register relatif terhadap
+ * frame, kecuali disebut lain. Urutan harus sama dengan tabel dispatch di vm.cpp.
+ */
+enum VMOpcode {
+    OP_MOVE,        // R[a] = R[b]
+    OP_LOADK,       // R[a] = K[b]
+    OP_I2D,         // R[a] = (double)R[b]
+    OP_ADDD,        // R[a] = R[b] op R[c], double
+    OP_SUBD,
+    OP_MULD,
+    OP_DIVD,
+    OP_ADDI,        // R[a] = R[b] op R[c], int
+    OP_SUBI,
+    OP_MULI,
+    OP_DIVI,
+    OP_LTD,         // R[a] = R[b] < R[c], hasil int 0/1
+    OP_GTD,
+    OP_LTI,
+    OP_GTI,
+    OP_JMP,         // pc = b
+    OP_JMPF,        // apabila R[a] == 0: pc = b
+    OP_FORLOOP,     // R[a] += 1.0; apabila R[a] <= R[b]: pc = c (`muter ... tekan`)
+    OP_CALL,        // panggil fungsi b, argumen c buah mulai R[a], hasil di R[a]
+    OP_BUILTIN,     // sama dengan CALL untuk builtin b (VMBuiltin)
+    OP_RET,         // kembalikan R[a]
+    OP_RETV,        // kembali tanpa nilai
+    OP_COUNT
+};
+
+enum VMBuiltin {
+    BuiltinPrintf,
+    BuiltinPuts,
+    BuiltinWeruhi
+};
+
+struct VMInstr {
+    uint16_t op, a, b, c;
+};
+
+struct VMFunction {
+    std::string name;
+    VMType returnType;
+    std::vector<VMType> argTypes;   // argumen ada di R[0..n-1]
+    std::vector<VMInstr> code;
+    std::vector<VMValue> constants;
+    unsigned numRegisters;
+    int line;
+};
+
+struct VMProgram {
+    std::vector<VMFunction> functions;  // functions[0] adalah kode top level
+    std::deque<std::string> strings;    // isi literal string, alamatnya tidak berpindah
+};
+
+/**
+ * Turunkan AST program menjadi bytecode register. Bahasa yang didukung sama
+ * dengan codegen.cpp: int/double/str, fungsi, `nek`, `muter`, printf/puts/weruhi.
+ * Fungsi `njaba` butuh linker, jadi hanya bisa lewat backend LLVM.
+ * Mengembalikan false (pesan error sudah dicetak) apabila program tidak valid.
+ */
+bool compileBytecode(NBlock& root, VMProgram& program);
+
+/* Kode native fungsi yang sudah dipromosikan: argumen di args[0..n-1], hasil di args[0]. */
+typedef void (*VMNativeEntry)(VMValue *args);
+
+/**
+ * Counter satu fungsi untuk eksekusi bertingkat. Hanya thread interpreter yang
+ * menyentuhnya, kecuali `native` yang diisi thread compiler.
+ */
+struct VMProfile {
+    std::atomic<VMNativeEntry> native;
+    uint32_t calls;
+    uint32_t backEdges;
+    bool queued;
+
+    VMProfile() : native(nullptr), calls(0), backEdges(0), queued(false) { }
+};
+
+/**
+ * Hook eksekusi bertingkat (--tiered). Interpreter menghitung panggilan dan
+ * back-edge `muter` setiap fungsi; begitu jumlahnya mencapai `threshold`,
+ * `hot()` dipanggil sekali untuk fungsi itu. Panggilan ke fungsi yang
+ * `native`-nya sudah terisi langsung masuk ke kode native.
+ */
+class VMTier {
+public:
+    std::unique_ptr<VMProfile[]> profiles;     // index sama dengan VMProgram::functions
+    uint32_t threshold;
+
+    VMTier(size_t functions, uint32_t threshold) :
+        profiles(new VMProfile[functions]), threshold(threshold) { }
+    virtual ~VMTier() { }
+
+    virtual void hot(unsigned function) = 0;
+};
+
+/**
+ * Jalankan kode top level program di interpreter. Mengembalikan exit status.
+ */
+int runBytecode(const VMProgram& program, VMTier *tier = nullptr);
+
+#endif
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/Scalar.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include "wholeprogram.h"
+
+using namespace llvm;
+
+static unsigned instructionCount(const Function& function)
+{
+    unsigned count = 0;
+    for (Function::const_iterator bb = function.begin(); bb != function.end(); bb++) {
+        count += bb->size();
+    }
+    return count;
+}
+
+static bool canSpecialize(const Function& function)
+{
+    return !function.isDeclaration() && function.hasLocalLinkage() && !function.isVarArg();
+}
+
+/**
+ * Clone fungsi untuk setiap kombinasi argumen konstan dari call site.
+ * Argumen konstan dihapus dari signature clone, nilainya dilipat ke body.
+ * Total instruksi yang di-clone tidak lebih dari `budget`.
+ */
+static unsigned specializeConstantArguments(Module& module, unsigned budget)
+{
+    typedef std::pair<Function*, std::vector<Constant*> > SpecKey;
+    std::map<SpecKey, Function*> clones;
+    unsigned used = 0;
+
+    // kumpulkan dulu, module berubah selama cloning
+    std::vector<CallInst*> calls;
+    for (Module::iterator f = module.begin(); f != module.end(); f++) {
+        if (!canSpecialize(*f)) {
+            continue;
+        }
+        for (User *user : f->users()) {
+            CallInst *call = dyn_cast<CallInst>(user);
+            if (call == nullptr || call->getCalledFunction() != &*f) {
+                continue;
+            }
+            for (unsigned i = 0; i < call->getNumArgOperands(); i++) {
+                if (isa<Constant>(call->getArgOperand(i))) {
+                    calls.push_back(call);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (CallInst *call : calls) {
+        Function *callee = call->getCalledFunction();
+
+        SpecKey key(callee, std::vector<Constant*>());
+        for (unsigned i = 0; i < call->getNumArgOperands(); i++) {
+            key.second.push_back(dyn_cast<Constant>(call->getArgOperand(i)));
+        }
+
+        Function *clone;
+        std::map<SpecKey, Function*>::iterator found = clones.find(key);
+        if (found != clones.end()) {
+            clone = found->second;
+        }else{
+            unsigned size = instructionCount(*callee);
+            if (used + size > budget) {
+                continue;
+            }
+
+            ValueToValueMapTy vmap;
+            unsigned i = 0;
+            for (Function::arg_iterator arg = callee->arg_begin(); arg != callee->arg_end(); arg++, i++) {
+                if (key.second[i] != nullptr) {
+                    vmap[&*arg] = key.second[i];
+                }
+            }
+
+            clone = CloneFunction(callee, vmap, false);
+            clone->setLinkage(GlobalValue::InternalLinkage);
+            clone->setName(callee->getName() + ".khusus");
+            module.getFunctionList().push_back(clone);
+
+            clones[key] = clone;
+            used += size;
+        }
+
+        std::vector<Value*> args;
+        for (unsigned i = 0; i < call->getNumArgOperands(); i++) {
+            if (key.second[i] == nullptr) {
+                args.push_back(call->getArgOperand(i));
+            }
+        }
+
+        CallInst *newCall = CallInst::Create(clone, args, "", call);
+        newCall->setCallingConv(clone->getCallingConv());
+        newCall->setTailCall(call->isTailCall());
+        newCall->takeName(call);
+        call->replaceAllUsesWith(newCall);
+        call->eraseFromParent();
+    }
+
+    std::cout << "Specialized " << clones.size() << " function clone(s), "
+              << used << "/" << budget << " instructions" << std::endl;
+    return clones.size();
+}
+
+/**
+ * Fungsi internal yang alamatnya tidak pernah diambil boleh memakai
+ * calling convention fastcc, semua call site ikut diubah.
+ */
+static unsigned useFastCallingConv(Module& module)
+{
+    unsigned count = 0;
+    for (Module::iterator f = module.begin(); f != module.end(); f++) {
+        if (f->isDeclaration() || !f->hasLocalLinkage() || f->isVarArg() || f->hasAddressTaken()) {
+            continue;
+        }
+        f->setCallingConv(CallingConv::Fast);
+        for (User *user : f->users()) {
+            CallSite cs(user);
+            if (cs) {
+                cs.setCallingConv(CallingConv::Fast);
+            }
+        }
+        count++;
+    }
+    std::cout << "fastcc: " << count << " function(s)" << std::endl;
+    return count;
+}
+
+void optimizeWholeProgram(Module& module, const CompileOptions& opts)
+{
+    std::cout << "Whole program optimization..." << std::endl;
+
+    {
+        legacy::PassManager pm;
+        const char *exported[] = { "main" };
+        pm.add(createInternalizePass(exported));
+        pm.add(createGlobalDCEPass());
+        pm.run(module);
+    }
+
+    specializeConstantArguments(module, opts.specializeBudget);
+    useFastCallingConv(module);
+
+    legacy::PassManager pm;
+    pm.add(createIPSCCPPass());             // propagasi konstanta antar fungsi
+    pm.add(createGlobalOptimizerPass());
+    pm.add(createDeadArgEliminationPass()); // buang argumen yang tidak terpakai
+    pm.add(createArgumentPromotionPass());
+    pm.add(createInstructionCombiningPass());
+    pm.add(createCFGSimplificationPass());
+    pm.add(createGlobalDCEPass());
+    pm.run(module);
+}
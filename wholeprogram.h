@@ -0,0 +1,16 @@
+#ifndef BOSOJOWO_WHOLEPROGRAM_H
+#define BOSOJOWO_WHOLEPROGRAM_H
+
+#include <llvm/IR/Module.h>
+
+#include "options.h"
+
+/**
+ * Optimasi --whole-program: module dianggap tertutup (hanya `main` yang
+ * dipanggil dari luar). Semua fungsi di-internalize, fungsi internal
+ * memakai fastcc, fungsi yang dipanggil dengan argumen konstan di-clone
+ * (dibatasi --spec-budget), lalu argumen yang tidak terpakai dibuang.
+ */
+void optimizeWholeProgram(llvm::Module& module, const CompileOptions& opts);
+
+#endif